@@ -0,0 +1,470 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_ACCESSORCORE_H_306182947530
+#define ACCESSORPP_ACCESSORCORE_H_306182947530
+
+#include "accessorpp/getter.h"
+#include "accessorpp/setter.h"
+#include "accessorpp/common.h"
+#include "accessorpp/error.h"
+
+#include <functional>
+#include <type_traits>
+#include <cstddef>
+
+namespace accessorpp {
+
+namespace private_ {
+
+struct DefaultGetter {};
+struct DefaultSetter {};
+struct NoSetter {};
+
+} // namespace private_
+
+constexpr private_::DefaultGetter defaultGetter;
+constexpr private_::DefaultSetter defaultSetter;
+constexpr private_::NoSetter noSetter;
+
+struct InternalStorage {};
+struct ExternalStorage {};
+// The value is stored in the Accessor, the getter and setter can't be changed.
+// The Accessor can be constructed, read and written in constant expressions.
+struct LiteralStorage {};
+
+// The default Instrumentation policy. The hooks are never called, and it takes no space.
+// The counting instrumentations are in accessorpp/instrumentation.h, the tracing is in accessorpp/trace.h.
+struct NoInstrumentation
+{
+	void onGet() const {
+	}
+
+	void onSetBegin() const {
+	}
+
+	void onSetEnd() const {
+	}
+
+	void onSuppressedSet() const {
+	}
+
+	void onCallbackBegin() const {
+	}
+
+	void onCallbackEnd() const {
+	}
+};
+
+#include "accessorpp/internal/accessor_i.h"
+
+namespace private_ {
+
+template <typename Operator, typename L, typename R>
+class AccessorBinaryExpression;
+
+template <typename Operator, typename A>
+class AccessorUnaryExpression;
+
+template <typename T>
+struct IsAccessorExpression : std::false_type
+{
+};
+
+template <typename Operator, typename L, typename R>
+struct IsAccessorExpression <AccessorBinaryExpression<Operator, L, R> > : std::true_type
+{
+};
+
+template <typename Operator, typename A>
+struct IsAccessorExpression <AccessorUnaryExpression<Operator, A> > : std::true_type
+{
+};
+
+} // namespace private_
+
+template <
+	typename Type,
+	typename PoliciesType = DefaultPolicies
+>
+class Accessor :
+	public private_::AccessorBase<
+			Type,
+			typename private_::ResolvedPolicies<PoliciesType>::Storage,
+			PoliciesType
+		>,
+	public private_::OnChangingCallback<
+			typename private_::ResolvedPolicies<PoliciesType>::OnChangingCallback,
+			typename private_::ResolvedPolicies<PoliciesType>::CallbackData
+		>,
+	public private_::OnChangedCallback<
+			typename private_::ResolvedPolicies<PoliciesType>::OnChangedCallback,
+			typename private_::ResolvedPolicies<PoliciesType>::CallbackData
+		>,
+	public private_::InstrumentationHolder<
+			typename private_::ResolvedPolicies<PoliciesType>::Instrumentation
+		>
+{
+private:
+	using Resolved = private_::ResolvedPolicies<PoliciesType>;
+	using BaseType = private_::AccessorBase<
+			Type,
+			typename Resolved::Storage,
+			PoliciesType
+		>;
+	using OnChangingCallbackType = private_::OnChangingCallback<
+			typename Resolved::OnChangingCallback,
+			typename Resolved::CallbackData
+		>;
+	using OnChangedCallbackType = private_::OnChangedCallback<
+			typename Resolved::OnChangedCallback,
+			typename Resolved::CallbackData
+		>;
+
+public:
+	using ValueType = Type;
+	using UnderlyingType = typename private_::GetUnderlyingType<Type>::Type;
+	using GetterType = typename BaseType::GetterType;
+	using SetterType = typename BaseType::SetterType;
+
+	static constexpr bool internalStorage = Resolved::internalStorage;
+	static constexpr bool literalStorage = Resolved::literalStorage;
+	static constexpr bool instrumented = Resolved::instrumented;
+
+private:
+	using InstrumentationType = typename Resolved::Instrumentation;
+	using InstrumentationHolderType = private_::InstrumentationHolder<InstrumentationType>;
+	using SetScope = private_::InstrumentationScope<
+		InstrumentationType, &InstrumentationType::onSetEnd, instrumented
+	>;
+	using OnChangingScope = private_::InstrumentationScope<
+		InstrumentationType, &InstrumentationType::onCallbackEnd, instrumented && Resolved::hasOnChangingCallback
+	>;
+	using OnChangedScope = private_::InstrumentationScope<
+		InstrumentationType, &InstrumentationType::onCallbackEnd, instrumented && Resolved::hasOnChangedCallback
+	>;
+
+public:
+	constexpr Accessor() noexcept
+		: BaseType()
+	{
+	}
+
+	// The explict static_cast is required, otherwise it will call
+	// template <typename P1> explicit AccessorBase(P1 && p2)
+	// The instrumentation is copied too, so a counting instrumentation keeps the name and registers the copy.
+	constexpr Accessor(const Accessor & other)
+		:
+			BaseType(static_cast<const BaseType &>(other)),
+			InstrumentationHolderType(static_cast<const InstrumentationHolderType &>(other))
+	{
+	}
+
+	using BaseType::BaseType;
+
+	// Allows Accessor<int> sum = a + b. Without it the copy initialization needs two
+	// user defined conversions, from the expression to the value, then to the Accessor.
+	template <typename E>
+	constexpr Accessor(const E & expression,
+		typename std::enable_if<private_::IsAccessorExpression<E>::value>::type * = nullptr)
+		: BaseType(static_cast<UnderlyingType>(expression.get()))
+	{
+	}
+
+	// Only the value is assigned, the instrumentation of this accessor is kept.
+	ACCESSORPP_CONSTEXPR14 Accessor & operator = (const Accessor & other) {
+		*this = other.get();
+		return *this;
+	}
+
+	ACCESSORPP_CONSTEXPR14 Accessor & operator = (const ValueType & newValue) {
+		return this->set(newValue);
+	}
+
+	// Resolves the ambiguity between the two assignments above, both are reachable
+	// from an expression through the converting constructor or ValueType.
+	template <typename E>
+	ACCESSORPP_CONSTEXPR14 auto operator = (const E & expression)
+		-> typename std::enable_if<private_::IsAccessorExpression<E>::value, Accessor &>::type
+	{
+		return this->set(expression.get());
+	}
+
+	ACCESSORPP_CONSTEXPR14 Accessor & set(const ValueType & newValue, void * instance = nullptr) {
+		if(doCheckSet()) {
+			const SetScope scope(this->getInstrumentation());
+			doSet(newValue, instance);
+		}
+		return *this;
+	}
+
+	// Same as set, but the error is returned instead of being passed to the error handler.
+	ACCESSORPP_CONSTEXPR14 ErrorCode trySet(const ValueType & newValue, void * instance = nullptr) {
+		if(this->isReadOnly()) {
+			if(instrumented) {
+				this->getInstrumentation().onSuppressedSet();
+			}
+			return ErrorCode::readOnly;
+		}
+		if(instrumented) {
+			this->getInstrumentation().onSetBegin();
+		}
+		const SetScope scope(this->getInstrumentation());
+		doSet(newValue, instance);
+		return ErrorCode::ok;
+	}
+
+	template <typename CD>
+	Accessor & setWithCallbackData(const ValueType & newValue, CD && callbackData, void * instance = nullptr) {
+		if(! doCheckSet()) {
+			return *this;
+		}
+
+		const SetScope scope(this->getInstrumentation());
+		doInvokeOnChanging(newValue, std::forward<CD>(callbackData));
+		this->doSetValue(newValue, instance);
+		doInvokeOnChanged(newValue, std::forward<CD>(callbackData));
+		return *this;
+	}
+
+	// Set the value to func(oldValue) in one step. func is "UnderlyingType (const UnderlyingType & oldValue)".
+	// The storage may implement it without calling the getter and setter, and
+	// the concurrent storages implement it atomically. For the concurrent storages,
+	// func and OnChangingCallback may be invoked more than once if other threads
+	// change the value at the same time. OnChangedCallback is invoked once.
+	template <typename F>
+	ACCESSORPP_CONSTEXPR17 Accessor & update(F && func, void * instance = nullptr) {
+		if(! doCheckSet()) {
+			return *this;
+		}
+
+		const SetScope scope(this->getInstrumentation());
+		this->doUpdate(
+			std::forward<F>(func),
+			[this](const UnderlyingType & newValue) {
+				this->doInvokeOnChanging(newValue);
+			},
+			[this](const UnderlyingType & newValue) {
+				this->doInvokeOnChanged(newValue);
+			},
+			instance
+		);
+		return *this;
+	}
+
+	constexpr ValueType get(const void * instance = nullptr) const {
+		return instrumented ? doInstrumentedGet(instance) : this->doGetValue(instance);
+	}
+
+	constexpr operator ValueType() const {
+		return get();
+	}
+
+	template <typename F>
+	void setGetter(const F & newGetter) {
+		this->getter = GetterType(newGetter);
+		this->doClearDirectAccess();
+	}
+
+	template <typename F>
+	void setSetter(const F & newSetter) {
+		this->setter = SetterType(newSetter);
+		this->doClearDirectAccess();
+	}
+
+private:
+	ACCESSORPP_CONSTEXPR14 void doSet(const ValueType & newValue, void * instance) {
+		doInvokeOnChanging(newValue);
+		this->doSetValue(newValue, instance);
+		doInvokeOnChanged(newValue);
+	}
+
+	// Same as doCheckWritable, and reports the suppressed set, or the beginning of the set.
+	// If it returns true, the caller must end the set with a SetScope.
+	ACCESSORPP_CONSTEXPR14 bool doCheckSet() const {
+		if(instrumented) {
+			if(this->isReadOnly()) {
+				this->getInstrumentation().onSuppressedSet();
+			}
+			else {
+				this->getInstrumentation().onSetBegin();
+			}
+		}
+		return this->doCheckWritable();
+	}
+
+	ValueType doInstrumentedGet(const void * instance) const {
+		this->getInstrumentation().onGet();
+		return this->doGetValue(instance);
+	}
+
+	template <typename V, typename ...Data>
+	ACCESSORPP_CONSTEXPR14 void doInvokeOnChanging(const V & newValue, Data && ...data) {
+		if(instrumented && Resolved::hasOnChangingCallback) {
+			this->getInstrumentation().onCallbackBegin();
+		}
+		const OnChangingScope scope(this->getInstrumentation());
+		this->OnChangingCallbackType::invokeCallback(newValue, std::forward<Data>(data)...);
+	}
+
+	template <typename V, typename ...Data>
+	ACCESSORPP_CONSTEXPR14 void doInvokeOnChanged(const V & newValue, Data && ...data) {
+		if(instrumented && Resolved::hasOnChangedCallback) {
+			this->getInstrumentation().onCallbackBegin();
+		}
+		const OnChangedScope scope(this->getInstrumentation());
+		this->OnChangedCallbackType::invokeCallback(newValue, std::forward<Data>(data)...);
+	}
+
+private:
+	friend struct private_::AccessorFriend;
+};
+
+namespace private_ {
+
+// Gives the extensions, such as transactions, access to the protected members of Accessor.
+struct AccessorFriend
+{
+	template <typename A>
+	static bool checkWritable(const A & accessor) {
+		if(! accessor.doCheckSet()) {
+			return false;
+		}
+		// The storage sets the value later, the set ends here.
+		const typename A::SetScope scope(accessor.getInstrumentation());
+		return true;
+	}
+
+	template <typename A>
+	static void invokeOnChanged(A & accessor, const typename A::ValueType & newValue) {
+		accessor.doInvokeOnChanged(newValue);
+	}
+};
+
+} // namespace private_
+
+template <typename T>
+struct IsAccessor : std::false_type
+{
+};
+
+template <
+	typename Type,
+	typename PoliciesType
+>
+struct IsAccessor <Accessor<Type, PoliciesType> > : std::true_type
+{
+};
+
+template <typename T>
+struct AccessorValueType
+{
+	using Type = typename std::decay<T>::type;
+};
+
+template <
+	typename T,
+	typename PoliciesType
+>
+struct AccessorValueType <Accessor<T, PoliciesType> >
+{
+	using Type = typename Accessor<T, PoliciesType>::ValueType;
+};
+
+template <typename T, typename G, typename S, typename Policies>
+Accessor<T, Policies> createAccessor(G && getter, S && setter, Policies = Policies())
+{
+	return Accessor<T, Policies>(std::forward<G>(getter), std::forward<S>(setter));
+}
+
+template <
+	typename T,
+	typename G, typename IG, typename S, typename IS,
+	typename Policies = DefaultPolicies
+>
+Accessor<T, Policies> createAccessor(
+		G && getter, IG && getterInstance,
+		S && setter, IS && setterInstance,
+		Policies = Policies()
+	)
+{
+	return Accessor<T, Policies>(
+		std::forward<G>(getter), std::forward<IG>(getterInstance),
+		std::forward<S>(setter), std::forward<IS>(setterInstance)
+	);
+}
+
+template <typename G, typename S, typename Policies = DefaultPolicies>
+auto createAccessor(G && getter, S && setter, Policies = Policies())
+	-> Accessor<typename private_::DetectValueType<G>::Type, Policies>
+{
+	using A = Accessor<typename private_::DetectValueType<G>::Type, Policies>;
+	return A(
+		std::forward<G>(getter),
+		std::forward<S>(setter)
+	);
+}
+
+template <
+	typename G, typename IG, typename S, typename IS,
+	typename Policies = DefaultPolicies
+>
+auto createAccessor(
+		G && getter, IG && getterInstance,
+		S && setter, IS && setterInstance,
+		Policies = Policies()
+	)
+	-> Accessor<typename private_::DetectValueType<G>::Type, Policies>
+{
+	using A = Accessor<typename private_::DetectValueType<G>::Type, Policies>;
+	return A(
+		std::forward<G>(getter), std::forward<IG>(getterInstance),
+		std::forward<S>(setter), std::forward<IS>(setterInstance)
+	);
+}
+
+template <typename T, typename G, typename Policies = DefaultPolicies>
+Accessor<T, Policies> createReadOnlyAccessor(G && getter, Policies = Policies())
+{
+	using A = Accessor<T, Policies>;
+	return A(getter, noSetter);
+}
+
+template <typename T, typename G, typename IG, typename Policies>
+Accessor<T, Policies> createReadOnlyAccessor(G && getter, IG && getterInstance, Policies)
+{
+	using A = Accessor<T, Policies>;
+	return A(A::GetterType(std::forward<G>(getter), std::forward<IG>(getterInstance)), noSetter);
+}
+
+template <typename G, typename Policies = DefaultPolicies>
+auto createReadOnlyAccessor(G && getter, Policies = Policies())
+	-> Accessor<typename private_::DetectValueType<G>::Type, Policies>
+{
+	using A = Accessor<typename private_::DetectValueType<G>::Type, Policies>;
+	return A(std::forward<G>(getter), noSetter);
+}
+
+template <typename G, typename IG, typename Policies>
+auto createReadOnlyAccessor(G && getter, IG && getterInstance, Policies)
+	-> Accessor<typename private_::DetectValueType<G>::Type, Policies>
+{
+	using A = Accessor<typename private_::DetectValueType<G>::Type, Policies>;
+	return A(A::GetterType(std::forward<G>(getter), std::forward<IG>(getterInstance)), noSetter);
+}
+
+
+} // namespace accessorpp
+
+#endif
+
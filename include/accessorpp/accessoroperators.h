@@ -0,0 +1,787 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_ACCESSOROPERATORS_H_847205193664
+#define ACCESSORPP_ACCESSOROPERATORS_H_847205193664
+
+#include "accessorpp/accessorcore.h"
+
+#include <type_traits>
+
+namespace accessorpp {
+
+namespace private_ {
+
+// Plain values are stored in the expression by value.
+template <typename T, typename Enabled = void>
+struct ExpressionOperand
+{
+	using StoredType = typename std::decay<const T>::type;
+	using ValueType = StoredType;
+
+	static constexpr const StoredType & evaluate(const StoredType & operand) {
+		return operand;
+	}
+};
+
+// Accessors are stored by reference, the accessor must outlive the expression.
+template <typename T>
+struct ExpressionOperand <T, typename std::enable_if<IsAccessor<T>::value>::type>
+{
+	using StoredType = const T &;
+	using ValueType = typename T::ValueType;
+
+	static constexpr ValueType evaluate(const T & operand) {
+		return operand.get();
+	}
+};
+
+template <typename T>
+struct ExpressionOperand <T, typename std::enable_if<IsAccessorExpression<T>::value>::type>
+{
+	using StoredType = T;
+	using ValueType = typename T::ValueType;
+
+	static constexpr ValueType evaluate(const T & operand) {
+		return operand.get();
+	}
+};
+
+// The type of an operand stored in an expression. An accessor which is a temporary, such as the result
+// of a function, is destroyed at the end of the full expression, so it's read when the expression is
+// created and its value is stored. Other accessors are stored by reference and read when the expression
+// is evaluated.
+template <typename T, typename Enabled = void>
+struct ExpressionOperandType
+{
+	using Type = typename std::decay<T>::type;
+};
+
+template <typename T>
+struct ExpressionOperandType <T, typename std::enable_if<
+		! std::is_lvalue_reference<T>::value && IsAccessor<typename std::decay<T>::type>::value
+	>::type>
+{
+	using Type = typename std::decay<typename std::decay<T>::type::ValueType>::type;
+};
+
+template <typename T>
+struct IsExpressionOperand : std::integral_constant<bool,
+		IsAccessor<typename std::decay<T>::type>::value || IsAccessorExpression<typename std::decay<T>::type>::value
+	>
+{
+};
+
+template <typename Operator, typename T, typename U>
+struct MakeBinaryExpression : std::enable_if<
+		IsExpressionOperand<T>::value,
+		AccessorBinaryExpression<Operator, typename ExpressionOperandType<T>::Type, typename ExpressionOperandType<U>::Type>
+	>
+{
+};
+
+template <typename Operator, typename T>
+struct MakeUnaryExpression : std::enable_if<
+		IsExpressionOperand<T>::value,
+		AccessorUnaryExpression<Operator, typename ExpressionOperandType<T>::Type>
+	>
+{
+};
+
+// The arithmetic operators on accessors return expressions instead of accessors.
+// An expression such as a + b * c reads each accessor once when it's evaluated,
+// by get() or converting to ValueType, and doesn't create any accessor.
+// Beware of holding an expression with auto, such as auto e = a + b. e refers to a and b, it must not
+// outlive them, and it reads them each time it's evaluated, so it sees the writes after it's created.
+// Converting the expression to a value, such as int sum = a + b, reads the accessors immediately.
+template <typename Operator, typename L, typename R>
+class AccessorBinaryExpression
+{
+private:
+	using LeftOperand = ExpressionOperand<L>;
+	using RightOperand = ExpressionOperand<R>;
+
+public:
+	using ValueType = typename std::decay<decltype(Operator::apply(
+		std::declval<typename LeftOperand::ValueType>(),
+		std::declval<typename RightOperand::ValueType>()
+	))>::type;
+
+public:
+	constexpr AccessorBinaryExpression(const L & left, const R & right)
+		: left(left), right(right)
+	{
+	}
+
+	constexpr ValueType get() const {
+		return Operator::apply(LeftOperand::evaluate(left), RightOperand::evaluate(right));
+	}
+
+	constexpr operator ValueType() const {
+		return get();
+	}
+
+private:
+	typename LeftOperand::StoredType left;
+	typename RightOperand::StoredType right;
+};
+
+template <typename Operator, typename A>
+class AccessorUnaryExpression
+{
+private:
+	using Operand = ExpressionOperand<A>;
+
+public:
+	using ValueType = typename std::decay<decltype(Operator::apply(
+		std::declval<typename Operand::ValueType>()
+	))>::type;
+
+public:
+	constexpr explicit AccessorUnaryExpression(const A & operand)
+		: operand(operand)
+	{
+	}
+
+	constexpr ValueType get() const {
+		return Operator::apply(Operand::evaluate(operand));
+	}
+
+	constexpr operator ValueType() const {
+		return get();
+	}
+
+private:
+	typename Operand::StoredType operand;
+};
+
+struct ExpressionOperatorLogicalNot
+{
+	template <typename T>
+	static constexpr auto apply(const T & a) -> decltype(! a)
+	{
+		return ! a;
+	}
+};
+
+struct ExpressionOperatorUnaryPlus
+{
+	template <typename T>
+	static constexpr auto apply(const T & a) -> decltype(+a)
+	{
+		return +a;
+	}
+};
+
+struct ExpressionOperatorNegate
+{
+	template <typename T>
+	static constexpr auto apply(const T & a) -> decltype(-a)
+	{
+		return -a;
+	}
+};
+
+enum class ComparisonOperandKind
+{
+	plain,
+	value,
+	reference
+};
+
+template <typename T, typename Enabled = void>
+struct GetComparisonOperandKind
+{
+	static constexpr ComparisonOperandKind value = IsAccessorExpression<T>::value
+		? ComparisonOperandKind::value : ComparisonOperandKind::plain;
+};
+
+template <typename T>
+struct GetComparisonOperandKind <T, typename std::enable_if<IsAccessor<T>::value>::type>
+{
+	static constexpr ComparisonOperandKind value = ((T::internalStorage || T::literalStorage) && ! T::instrumented)
+		? ComparisonOperandKind::reference : ComparisonOperandKind::value;
+};
+
+// Used by the comparison operators. It invokes func with a const reference to the operand value.
+// Plain values are passed as is without casting, so heterogeneous comparisons such as
+// std::string with const char * don't create temporaries.
+template <typename T, ComparisonOperandKind kind = GetComparisonOperandKind<T>::value>
+struct ComparisonOperand
+{
+	template <typename F>
+	static constexpr bool apply(const T & operand, F && func) {
+		return func(operand);
+	}
+};
+
+template <typename T>
+struct ComparisonOperand <T, ComparisonOperandKind::value>
+{
+	template <typename F>
+	static constexpr bool apply(const T & operand, F && func) {
+		return func(static_cast<const typename AccessorValueType<T>::Type &>(operand.get()));
+	}
+};
+
+// The accessor using InternalStorage with the default getter, or LiteralStorage, is compared by reference, without calling the getter.
+template <typename T>
+struct ComparisonOperand <T, ComparisonOperandKind::reference>
+{
+	template <typename F>
+	static constexpr bool apply(const T & operand, F && func) {
+		return operand.isDirectAccess()
+			? func(operand.directGet())
+			: func(static_cast<const typename T::UnderlyingType &>(operand.get()))
+		;
+	}
+};
+
+template <typename Operator, typename L>
+struct CompareWithLeft
+{
+	template <typename R>
+	constexpr bool operator () (const R & right) const {
+		return Operator::apply(left, right);
+	}
+
+	const L & left;
+};
+
+template <typename Operator, typename U>
+struct CompareWithRight
+{
+	template <typename L>
+	constexpr bool operator () (const L & left) const {
+		return ComparisonOperand<U>::apply(right, CompareWithLeft<Operator, L> { left });
+	}
+
+	const U & right;
+};
+
+template <typename Operator, typename T, typename U>
+constexpr bool compareOperands(const T & a, const U & b)
+{
+	return ComparisonOperand<T>::apply(a, CompareWithRight<Operator, U> { b });
+}
+
+} // namespace private_
+
+template <typename Operator, typename L, typename R>
+struct AccessorValueType <private_::AccessorBinaryExpression<Operator, L, R> >
+{
+	using Type = typename private_::AccessorBinaryExpression<Operator, L, R>::ValueType;
+};
+
+template <typename Operator, typename A>
+struct AccessorValueType <private_::AccessorUnaryExpression<Operator, A> >
+{
+	using Type = typename private_::AccessorUnaryExpression<Operator, A>::ValueType;
+};
+
+// Unary operators
+
+template <typename T>
+ACCESSORPP_CONSTEXPR17 auto operator ++ (T & a)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	a += 1;
+	return a;
+}
+
+template <typename T>
+ACCESSORPP_CONSTEXPR17 auto operator ++ (T & a, int)
+	-> typename std::enable_if<IsAccessor<T>::value, typename T::UnderlyingType>::type
+{
+	using V = typename T::UnderlyingType;
+	V result = V();
+	a.update([&result](const V & oldValue) -> V {
+		result = oldValue;
+		return (V)(oldValue + 1);
+	});
+	return result;
+}
+
+template <typename T>
+ACCESSORPP_CONSTEXPR17 auto operator -- (T & a)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	a -= 1;
+	return a;
+}
+
+template <typename T>
+ACCESSORPP_CONSTEXPR17 auto operator -- (T & a, int)
+	-> typename std::enable_if<IsAccessor<T>::value, typename T::UnderlyingType>::type
+{
+	using V = typename T::UnderlyingType;
+	V result = V();
+	a.update([&result](const V & oldValue) -> V {
+		result = oldValue;
+		return (V)(oldValue - 1);
+	});
+	return result;
+}
+
+template <typename T>
+constexpr auto operator ! (T && a)
+	-> typename private_::MakeUnaryExpression<private_::ExpressionOperatorLogicalNot, T>::type
+{
+	return typename private_::MakeUnaryExpression<private_::ExpressionOperatorLogicalNot, T>::type(a);
+}
+
+template <typename T>
+constexpr auto operator + (T && a)
+	-> typename private_::MakeUnaryExpression<private_::ExpressionOperatorUnaryPlus, T>::type
+{
+	return typename private_::MakeUnaryExpression<private_::ExpressionOperatorUnaryPlus, T>::type(a);
+}
+
+template <typename T>
+constexpr auto operator - (T && a)
+	-> typename private_::MakeUnaryExpression<private_::ExpressionOperatorNegate, T>::type
+{
+	return typename private_::MakeUnaryExpression<private_::ExpressionOperatorNegate, T>::type(a);
+}
+
+
+
+
+// Below operators are generated from tool generateops.py.
+// Using C style cast because static_cast may fail on some case, such as char[]
+
+
+
+// Expression operators
+
+namespace private_ {
+
+struct ExpressionOperatorAdd
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a + b)
+	{
+		return a + b;
+	}
+};
+
+struct ExpressionOperatorSubtract
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a - b)
+	{
+		return a - b;
+	}
+};
+
+struct ExpressionOperatorMultiply
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a * b)
+	{
+		return a * b;
+	}
+};
+
+struct ExpressionOperatorDivide
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a / b)
+	{
+		return a / b;
+	}
+};
+
+struct ExpressionOperatorModulo
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a % b)
+	{
+		return a % b;
+	}
+};
+
+struct ExpressionOperatorBitAnd
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a & b)
+	{
+		return a & b;
+	}
+};
+
+struct ExpressionOperatorBitOr
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a | b)
+	{
+		return a | b;
+	}
+};
+
+struct ExpressionOperatorBitXor
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a ^ b)
+	{
+		return a ^ b;
+	}
+};
+
+struct ExpressionOperatorShiftLeft
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a << b)
+	{
+		return a << b;
+	}
+};
+
+struct ExpressionOperatorShiftRight
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a >> b)
+	{
+		return a >> b;
+	}
+};
+
+struct ComparisonOperatorEqual
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a == b;
+	}
+};
+
+struct ComparisonOperatorNotEqual
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a != b;
+	}
+};
+
+struct ComparisonOperatorGreater
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a > b;
+	}
+};
+
+struct ComparisonOperatorGreaterEqual
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a >= b;
+	}
+};
+
+struct ComparisonOperatorLess
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a < b;
+	}
+};
+
+struct ComparisonOperatorLessEqual
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a <= b;
+	}
+};
+
+struct ComparisonOperatorLogicalAnd
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a && b;
+	}
+};
+
+struct ComparisonOperatorLogicalOr
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a || b;
+	}
+};
+
+} // namespace private_
+
+// Logic operators
+
+template <typename T, typename U>
+constexpr auto operator == (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
+{
+	return private_::compareOperands<private_::ComparisonOperatorEqual>(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator != (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
+{
+	return private_::compareOperands<private_::ComparisonOperatorNotEqual>(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator > (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
+{
+	return private_::compareOperands<private_::ComparisonOperatorGreater>(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator >= (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
+{
+	return private_::compareOperands<private_::ComparisonOperatorGreaterEqual>(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator < (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
+{
+	return private_::compareOperands<private_::ComparisonOperatorLess>(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator <= (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
+{
+	return private_::compareOperands<private_::ComparisonOperatorLessEqual>(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator && (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
+{
+	return private_::compareOperands<private_::ComparisonOperatorLogicalAnd>(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator || (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
+{
+	return private_::compareOperands<private_::ComparisonOperatorLogicalOr>(a, b);
+}
+// Binary operators
+
+template <typename T, typename U>
+constexpr auto operator + (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorAdd, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorAdd, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator - (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorSubtract, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorSubtract, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator * (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorMultiply, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorMultiply, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator / (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorDivide, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorDivide, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator % (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorModulo, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorModulo, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator & (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorBitAnd, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorBitAnd, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator | (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorBitOr, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorBitOr, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator ^ (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorBitXor, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorBitXor, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator << (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorShiftLeft, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorShiftLeft, T, U>::type(a, b);
+}
+
+template <typename T, typename U>
+constexpr auto operator >> (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperatorShiftRight, T, U>::type
+{
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperatorShiftRight, T, U>::type(a, b);
+}
+// Binary assignment operators
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator += (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue + value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator -= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue - value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator *= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue * value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator /= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue / value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator %= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue % value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator &= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue & value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator |= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue | value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator ^= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue ^ value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator <<= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue << value);
+	});
+	return a;
+}
+
+template <typename T, typename U>
+ACCESSORPP_CONSTEXPR17 auto operator >>= (T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
+{
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue >> value);
+	});
+	return a;
+}
+
+
+} // namespace accessorpp
+
+#endif
+
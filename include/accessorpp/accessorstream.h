@@ -0,0 +1,46 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_ACCESSORSTREAM_H_519370264815
+#define ACCESSORPP_ACCESSORSTREAM_H_519370264815
+
+#include "accessorpp/accessorcore.h"
+
+#include <istream>
+#include <ostream>
+
+namespace accessorpp {
+
+template <typename T>
+auto operator << (std::ostream & stream, const T & accessor)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, std::ostream &>::type
+{
+	stream << accessor.get();
+	return stream;
+}
+
+template <typename T>
+auto operator >> (std::istream & stream, T & accessor)
+	-> typename std::enable_if<IsAccessor<T>::value, std::istream &>::type
+{
+	typename T::ValueType value;
+	stream >> value;
+	accessor = value;
+	return stream;
+}
+
+
+} // namespace accessorpp
+
+#endif
+
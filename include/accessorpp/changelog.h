@@ -0,0 +1,325 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_CHANGELOG_H_730482915736
+#define ACCESSORPP_CHANGELOG_H_730482915736
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace accessorpp {
+
+// What ChangeLog::push does when the ring buffer is full.
+enum class ChangeLogOverflow
+{
+	// Wait until the consumer frees a slot.
+	block,
+	// Discard the new record.
+	drop,
+	// Discard the oldest record. The consumer sees a gap in the sequence.
+	overwrite
+};
+
+template <typename T, typename CallbackDataType = void>
+struct ChangeRecord
+{
+	std::uint64_t sequence;
+	std::size_t id;
+	T value;
+	CallbackDataType callbackData;
+};
+
+template <typename T>
+struct ChangeRecord <T, void>
+{
+	std::uint64_t sequence;
+	std::size_t id;
+	T value;
+};
+
+namespace private_ {
+
+template <typename RecordType, typename CallbackDataType>
+struct ChangeRecordData
+{
+	static void assign(RecordType & record, const CallbackDataType & callbackData) {
+		record.callbackData = callbackData;
+	}
+};
+
+template <typename RecordType>
+struct ChangeRecordData <RecordType, void>
+{
+	template <typename D>
+	static void assign(RecordType & /*record*/, const D & /*callbackData*/) {
+	}
+};
+
+struct NoCallbackData {};
+
+} // namespace private_
+
+// ChangeLog is a bounded lock-free multi-producer ring buffer of change records.
+// Any number of threads can push, one consumer thread consumes the records in order.
+// All memory is allocated in the constructor, push never allocates
+// unless copying T or CallbackDataType does.
+template <typename T, typename CallbackDataType = void>
+class ChangeLog
+{
+public:
+	using Record = ChangeRecord<T, CallbackDataType>;
+
+private:
+	using CallbackDataHolder = typename std::conditional<
+		std::is_void<CallbackDataType>::value,
+		private_::NoCallbackData,
+		CallbackDataType
+	>::type;
+
+	struct Cell
+	{
+		std::atomic<std::uint64_t> sequence;
+		Record record;
+	};
+
+	enum { cacheLineSize = 64 };
+
+public:
+	// capacity is rounded up to power of 2.
+	explicit ChangeLog(const std::size_t capacity, const ChangeLogOverflow overflow = ChangeLogOverflow::block)
+		:
+			mask(roundUpCapacity(capacity) - 1),
+			overflow(overflow),
+			cellList(new Cell[mask + 1]),
+			enqueuePosition(0),
+			dequeuePosition(0),
+			droppedCount(0)
+	{
+		for(std::size_t i = 0; i <= mask; ++i) {
+			cellList[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	ChangeLog(const ChangeLog &) = delete;
+	ChangeLog & operator = (const ChangeLog &) = delete;
+
+	std::size_t getCapacity() const {
+		return mask + 1;
+	}
+
+	ChangeLogOverflow getOverflow() const {
+		return overflow;
+	}
+
+	// Number of records discarded by ChangeLogOverflow::drop or ChangeLogOverflow::overwrite.
+	std::uint64_t getDroppedCount() const {
+		return droppedCount.load(std::memory_order_relaxed);
+	}
+
+	// Return false if the record is dropped.
+	bool push(const std::size_t id, const T & value) {
+		return doPush(id, value, CallbackDataHolder());
+	}
+
+	bool push(const std::size_t id, const T & value, const CallbackDataHolder & callbackData) {
+		return doPush(id, value, callbackData);
+	}
+
+	// Invoke func(const Record & record) for at most maxCount records, in the order of sequence.
+	// Return the number of records consumed.
+	template <typename F>
+	std::size_t consume(F && func, const std::size_t maxCount = (std::numeric_limits<std::size_t>::max)()) {
+		std::size_t count = 0;
+		while(count < maxCount) {
+			std::uint64_t position;
+			Cell * cell = acquireForDequeue(position);
+			if(cell == nullptr) {
+				break;
+			}
+			func(static_cast<const Record &>(cell->record));
+			releaseForDequeue(cell, position);
+			++count;
+		}
+		return count;
+	}
+
+private:
+	bool doPush(const std::size_t id, const T & value, const CallbackDataHolder & callbackData) {
+		for(;;) {
+			std::uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+			for(;;) {
+				Cell * cell = &cellList[position & mask];
+				const std::uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const std::int64_t diff = (std::int64_t)sequence - (std::int64_t)position;
+				if(diff == 0) {
+					if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						cell->record.sequence = position;
+						cell->record.id = id;
+						cell->record.value = value;
+						private_::ChangeRecordData<Record, CallbackDataType>::assign(cell->record, callbackData);
+						cell->sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if(diff < 0) {
+					break;
+				}
+				else {
+					position = enqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+
+			// The buffer is full
+			switch(overflow) {
+			case ChangeLogOverflow::drop:
+				droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return false;
+
+			case ChangeLogOverflow::overwrite: {
+				std::uint64_t oldestPosition;
+				Cell * oldest = acquireForDequeue(oldestPosition);
+				if(oldest != nullptr) {
+					releaseForDequeue(oldest, oldestPosition);
+					droppedCount.fetch_add(1, std::memory_order_relaxed);
+				}
+				break;
+			}
+
+			default:
+				std::this_thread::yield();
+				break;
+			}
+		}
+	}
+
+	Cell * acquireForDequeue(std::uint64_t & position) {
+		position = dequeuePosition.load(std::memory_order_relaxed);
+		for(;;) {
+			Cell * cell = &cellList[position & mask];
+			const std::uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const std::int64_t diff = (std::int64_t)sequence - (std::int64_t)(position + 1);
+			if(diff == 0) {
+				if(dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					return cell;
+				}
+			}
+			else if(diff < 0) {
+				return nullptr;
+			}
+			else {
+				position = dequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void releaseForDequeue(Cell * cell, const std::uint64_t position) {
+		cell->sequence.store(position + mask + 1, std::memory_order_release);
+	}
+
+	static std::size_t roundUpCapacity(const std::size_t capacity) {
+		std::size_t result = 2;
+		while(result < capacity) {
+			result <<= 1;
+		}
+		return result;
+	}
+
+private:
+	const std::size_t mask;
+	const ChangeLogOverflow overflow;
+	std::unique_ptr<Cell[]> cellList;
+	char padding1[cacheLineSize];
+	std::atomic<std::uint64_t> enqueuePosition;
+	char padding2[cacheLineSize];
+	std::atomic<std::uint64_t> dequeuePosition;
+	char padding3[cacheLineSize];
+	std::atomic<std::uint64_t> droppedCount;
+};
+
+// ChangeLogCallback is used as the OnChangedCallback policy.
+// Each set on the accessor appends a record to the attached ChangeLog.
+template <typename T, typename CallbackDataType = void>
+class ChangeLogCallback
+{
+public:
+	using ChangeLogType = ChangeLog<T, CallbackDataType>;
+
+public:
+	ChangeLogCallback()
+		: changeLog(nullptr), id(0)
+	{
+	}
+
+	// Must be called before the accessor is set from any thread.
+	void attach(ChangeLogType & newChangeLog, const std::size_t newId) {
+		changeLog = &newChangeLog;
+		id = newId;
+	}
+
+	std::size_t getId() const {
+		return id;
+	}
+
+	void operator () (const T & newValue, const CallbackDataType & callbackData) {
+		if(changeLog != nullptr) {
+			changeLog->push(id, newValue, callbackData);
+		}
+	}
+
+private:
+	ChangeLogType * changeLog;
+	std::size_t id;
+};
+
+template <typename T>
+class ChangeLogCallback <T, void>
+{
+public:
+	using ChangeLogType = ChangeLog<T, void>;
+
+public:
+	ChangeLogCallback()
+		: changeLog(nullptr), id(0)
+	{
+	}
+
+	// Must be called before the accessor is set from any thread.
+	void attach(ChangeLogType & newChangeLog, const std::size_t newId) {
+		changeLog = &newChangeLog;
+		id = newId;
+	}
+
+	std::size_t getId() const {
+		return id;
+	}
+
+	void operator () (const T & newValue) {
+		if(changeLog != nullptr) {
+			changeLog->push(id, newValue);
+		}
+	}
+
+private:
+	ChangeLogType * changeLog;
+	std::size_t id;
+};
+
+
+} // namespace accessorpp
+
+#endif
@@ -38,6 +38,34 @@
 	#endif
 #endif
 
+// C++14 allows constexpr functions to modify objects, C++17 allows lambdas in constant expressions.
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+	#define ACCESSORPP_CONSTEXPR14 constexpr
+#else
+	#define ACCESSORPP_CONSTEXPR14
+#endif
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201603L
+	#define ACCESSORPP_CONSTEXPR17 constexpr
+#else
+	#define ACCESSORPP_CONSTEXPR17
+#endif
+
+
+// ACCESSORPP_NO_EXCEPTIONS can be defined by the user to avoid any throw.
+// It's defined automatically when exceptions are disabled, such as -fno-exceptions.
+#if ! defined(ACCESSORPP_NO_EXCEPTIONS) && ! defined(__cpp_exceptions) && ! defined(__EXCEPTIONS) && ! defined(_CPPUNWIND)
+	#define ACCESSORPP_NO_EXCEPTIONS
+#endif
+
+// Mark the error paths so they are not inlined into the hot path.
+#if defined(ACCESSORPP_COMPILER_VC) && ! defined(ACCESSORPP_COMPILER_CLANG)
+	#define ACCESSORPP_COLD __declspec(noinline)
+#elif defined(ACCESSORPP_COMPILER_GCC) || defined(ACCESSORPP_COMPILER_CLANG)
+	#define ACCESSORPP_COLD __attribute__((noinline, cold))
+#else
+	#define ACCESSORPP_COLD
+#endif
+
 
 #endif
 
@@ -0,0 +1,261 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_COMPUTED_H_139057264830
+#define ACCESSORPP_COMPUTED_H_139057264830
+
+#include "accessorpp/accessorcore.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+
+namespace accessorpp {
+
+// The value is computed by the getter provided by the user, and cached until
+// the accessor is invalidated. The accessor is read-only.
+// The sources added by dependOn invalidate the accessor when they change.
+struct ComputedStorage {};
+
+namespace private_ {
+
+struct ComputedState
+{
+	ComputedState() : dirty(true), dependentList() {
+	}
+
+	// The dependents are invalidated only when this state changes from clean to dirty.
+	// A clean dependent has read this state after it became dirty, which made it clean.
+	void invalidate() {
+		if(! dirty.exchange(true, std::memory_order_acq_rel)) {
+			for(const std::weak_ptr<ComputedState> & dependent : dependentList) {
+				const std::shared_ptr<ComputedState> state = dependent.lock();
+				if(state) {
+					state->invalidate();
+				}
+			}
+		}
+	}
+
+	std::atomic<bool> dirty;
+	std::vector<std::weak_ptr<ComputedState> > dependentList;
+};
+
+// If the computation throws, the accessor stays dirty.
+class ComputedRefreshScope
+{
+public:
+	explicit ComputedRefreshScope(ComputedState & computedState)
+		: state(computedState), finished(false)
+	{
+		// Clear the flag before computing, so a change during the computation is not lost.
+		state.dirty.store(false, std::memory_order_release);
+	}
+
+	~ComputedRefreshScope() {
+		if(! finished) {
+			state.dirty.store(true, std::memory_order_release);
+		}
+	}
+
+	ComputedRefreshScope(const ComputedRefreshScope &) = delete;
+	ComputedRefreshScope & operator = (const ComputedRefreshScope &) = delete;
+
+	void finish() {
+		finished = true;
+	}
+
+private:
+	ComputedState & state;
+	bool finished;
+};
+
+// The base of the accessors using ComputedStorage, dependOn uses it to tell
+// a computed source from other accessors.
+class ComputedStateHolder
+{
+public:
+	ComputedStateHolder() : state(std::make_shared<ComputedState>()) {
+	}
+
+	// The destroyed dependents are pruned here, so creating and destroying dependents
+	// doesn't grow the list without bound.
+	void addComputedDependent(const ComputedStateHolder & dependent) {
+		std::vector<std::weak_ptr<ComputedState> > & dependentList = state->dependentList;
+		dependentList.erase(
+			std::remove_if(
+				dependentList.begin(),
+				dependentList.end(),
+				[](const std::weak_ptr<ComputedState> & item) { return item.expired(); }
+			),
+			dependentList.end()
+		);
+		dependentList.push_back(dependent.state);
+	}
+
+protected:
+	std::shared_ptr<ComputedState> state;
+};
+
+} // namespace private_
+
+// Marks a computed accessor dirty, it can be appended to a callback list or invoked directly.
+// It holds a weak reference, invoking it after the accessor is destroyed does nothing.
+class ComputedInvalidator
+{
+public:
+	explicit ComputedInvalidator(const std::weak_ptr<private_::ComputedState> & computedState)
+		: state(computedState)
+	{
+	}
+
+	template <typename ...A>
+	void operator () (const A & ...) const {
+		const std::shared_ptr<private_::ComputedState> computedState = state.lock();
+		if(computedState) {
+			computedState->invalidate();
+		}
+	}
+
+private:
+	std::weak_ptr<private_::ComputedState> state;
+};
+
+namespace private_ {
+
+template <typename Type_, typename PoliciesType>
+class AccessorBase <Type_, ComputedStorage, PoliciesType>
+	: public AccessorRoot<Type_, PoliciesType>, public ComputedStateHolder
+{
+private:
+	using super = AccessorRoot<Type_, PoliciesType>;
+	using ValueType = typename std::remove_cv<typename std::remove_reference<Type_>::type>::type;
+
+	static_assert(! std::is_reference<Type_>::value, "ComputedStorage can't return reference.");
+
+public:
+	using GetterType = typename super::GetterType;
+	using SetterType = typename super::SetterType;
+
+public:
+	// Each source is an accessor, see dependOn.
+	template <typename G, typename ...Sources>
+	explicit AccessorBase(G && getter, Sources & ...sources)
+		:
+			super(makeGetter(), noSetter),
+			ComputedStateHolder(),
+			sourceGetter(std::forward<G>(getter)),
+			value(),
+			listenerRemoverList()
+	{
+		dependOn(sources...);
+	}
+
+	// The sources can't be copied, so neither can the accessor.
+	AccessorBase(const AccessorBase &) = delete;
+
+	// Remove the invalidators from the callback lists of the sources.
+	~AccessorBase() {
+		for(const std::function<void ()> & remover : listenerRemoverList) {
+			remover();
+		}
+	}
+
+	// Invalidate this accessor when source changes. If source uses ComputedStorage,
+	// this accessor is invalidated when source is invalidated. Otherwise
+	// source.onChanged() must be a callback list which has append and remove, such as
+	// ConcurrentCallbackList or eventpp::CallbackList, and the source must outlive this accessor.
+	// Must be called before the accessors are used by other threads.
+	template <typename S, typename ...Sources>
+	void dependOn(S & source, Sources & ...sources) {
+		doDependOn(source, std::is_base_of<ComputedStateHolder, S>());
+		dependOn(sources...);
+	}
+
+	void dependOn() {
+	}
+
+	// The next get computes the value again.
+	void invalidate() {
+		state->invalidate();
+	}
+
+	ComputedInvalidator getInvalidator() const {
+		return ComputedInvalidator(state);
+	}
+
+	bool isDirty() const {
+		return state->dirty.load(std::memory_order_acquire);
+	}
+
+	// Compute the value if it's dirty, then return the cached value.
+	// Getting the value concurrently from multiple threads is not safe.
+	const ValueType & getCached() const {
+		if(state->dirty.load(std::memory_order_acquire)) {
+			refresh();
+		}
+		return value;
+	}
+
+	const GetterType & getSourceGetter() const {
+		return sourceGetter;
+	}
+
+protected:
+	// Hides AccessorRoot::doGetValue, so Accessor::get doesn't call through the getter.
+	ValueType doGetValue(const void * /*instance*/) const {
+		return getCached();
+	}
+
+private:
+	void refresh() const {
+		ComputedRefreshScope scope(*state);
+		value = sourceGetter.get();
+		scope.finish();
+	}
+
+	template <typename S>
+	void doDependOn(S & source, std::true_type) {
+		source.addComputedDependent(*this);
+	}
+
+	template <typename S>
+	void doDependOn(S & source, std::false_type) {
+		auto & callbackList = source.onChanged();
+		const auto handle = callbackList.append(getInvalidator());
+		listenerRemoverList.push_back([&callbackList, handle]() {
+			callbackList.remove(handle);
+		});
+	}
+
+	GetterType makeGetter() {
+		return GetterType([this]() -> ValueType {
+			return this->getCached();
+		});
+	}
+
+private:
+	GetterType sourceGetter;
+	mutable ValueType value;
+	std::vector<std::function<void ()> > listenerRemoverList;
+};
+
+} // namespace private_
+
+
+} // namespace accessorpp
+
+#endif
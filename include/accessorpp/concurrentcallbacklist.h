@@ -0,0 +1,247 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_CONCURRENTCALLBACKLIST_H_851730264918
+#define ACCESSORPP_CONCURRENTCALLBACKLIST_H_851730264918
+
+#include <functional>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstddef>
+
+namespace accessorpp {
+
+template <typename Prototype>
+class ConcurrentCallbackList;
+
+// ConcurrentCallbackList is a thread safe callback list used as the OnChangingCallback
+// or OnChangedCallback policy.
+// Listeners can be appended and removed from any thread while other threads dispatch.
+// Dispatching iterates an immutable snapshot of the listeners without locking.
+// Appending and removing copy the snapshot under a mutex (copy on write).
+// Old snapshots are freed by the publisher if no dispatching is in progress, otherwise
+// by the last dispatcher leaving, so continuous dispatching doesn't accumulate them.
+// A removed listener is never invoked after remove() returns.
+template <typename RT, typename ...Args>
+class ConcurrentCallbackList <RT (Args...)>
+{
+public:
+	using Callback = std::function<RT (Args...)>;
+
+private:
+	struct Node
+	{
+		explicit Node(const Callback & callback)
+			: callback(callback), active(true), inFlightCount(0)
+		{
+		}
+
+		Callback callback;
+		std::atomic<bool> active;
+		std::atomic<std::size_t> inFlightCount;
+	};
+
+	using NodePtr = std::shared_ptr<Node>;
+	using NodeList = std::vector<NodePtr>;
+
+	// The nodes being invoked in current thread, used to allow a listener to remove itself.
+	struct DispatchFrame
+	{
+		const Node * node;
+		DispatchFrame * previous;
+	};
+
+public:
+	using Handle = std::weak_ptr<Node>;
+
+public:
+	ConcurrentCallbackList()
+		:
+			mutex(),
+			current(new NodeList()),
+			retiredList(),
+			hasRetired(false),
+			dispatchingCount(0)
+	{
+	}
+
+	ConcurrentCallbackList(const ConcurrentCallbackList &) = delete;
+	ConcurrentCallbackList & operator = (const ConcurrentCallbackList &) = delete;
+
+	~ConcurrentCallbackList() {
+		delete current.load(std::memory_order_acquire);
+		for(auto list : retiredList) {
+			delete list;
+		}
+	}
+
+	Handle append(const Callback & callback) {
+		NodePtr node = std::make_shared<Node>(callback);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		const NodeList * oldList = current.load(std::memory_order_relaxed);
+		NodeList * newList = new NodeList(*oldList);
+		newList->push_back(node);
+		publish(oldList, newList);
+		return Handle(node);
+	}
+
+	// Return false if the listener is not found.
+	// After remove returns, the listener is not running in any other thread and won't be invoked any more.
+	bool remove(const Handle & handle) {
+		NodePtr node = handle.lock();
+		if(! node) {
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			const NodeList * oldList = current.load(std::memory_order_relaxed);
+			NodeList * newList = new NodeList();
+			newList->reserve(oldList->size());
+			bool found = false;
+			for(const auto & item : *oldList) {
+				if(item == node) {
+					found = true;
+				}
+				else {
+					newList->push_back(item);
+				}
+			}
+			if(! found) {
+				delete newList;
+				return false;
+			}
+			publish(oldList, newList);
+		}
+
+		node->active.store(false, std::memory_order_seq_cst);
+		const std::size_t selfCount = getSelfInvokingCount(node.get());
+		while(node->inFlightCount.load(std::memory_order_seq_cst) > selfCount) {
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	std::size_t size() const {
+		DispatchGuard guard(*this);
+		return current.load(std::memory_order_acquire)->size();
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	void operator () (Args ...args) const {
+		DispatchGuard guard(*this);
+		const NodeList * nodeList = current.load(std::memory_order_seq_cst);
+		for(const auto & node : *nodeList) {
+			InvokeGuard invokeGuard(node.get());
+			if(node->active.load(std::memory_order_seq_cst)) {
+				node->callback(args...);
+			}
+		}
+	}
+
+private:
+	struct DispatchGuard
+	{
+		explicit DispatchGuard(const ConcurrentCallbackList & callbackList) : callbackList(callbackList) {
+			callbackList.dispatchingCount.fetch_add(1, std::memory_order_seq_cst);
+		}
+
+		~DispatchGuard() {
+			if(callbackList.dispatchingCount.fetch_sub(1, std::memory_order_seq_cst) == 1
+				&& callbackList.hasRetired.load(std::memory_order_seq_cst)) {
+				callbackList.reclaimRetired();
+			}
+		}
+
+		const ConcurrentCallbackList & callbackList;
+	};
+
+	struct InvokeGuard
+	{
+		explicit InvokeGuard(Node * node) : frame { node, getTopFrame() } {
+			node->inFlightCount.fetch_add(1, std::memory_order_seq_cst);
+			getTopFrame() = &frame;
+		}
+
+		~InvokeGuard() {
+			getTopFrame() = frame.previous;
+			const_cast<Node *>(frame.node)->inFlightCount.fetch_sub(1, std::memory_order_release);
+		}
+
+		DispatchFrame frame;
+	};
+
+	// Must be called with the mutex locked.
+	void publish(const NodeList * oldList, NodeList * newList) {
+		current.store(newList, std::memory_order_seq_cst);
+		retiredList.push_back(oldList);
+		hasRetired.store(true, std::memory_order_seq_cst);
+		freeRetiredIfIdle();
+	}
+
+	// Called by the last dispatcher leaving. If the mutex is busy, the holder is
+	// publishing and frees the lists itself, or the next dispatcher leaving does.
+	void reclaimRetired() const {
+		std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+		if(lock.owns_lock()) {
+			freeRetiredIfIdle();
+		}
+	}
+
+	// Must be called with the mutex locked.
+	// Any dispatching starting after the lists were retired sees the new list,
+	// so if nothing is dispatching, no one can see the retired lists.
+	void freeRetiredIfIdle() const {
+		if(dispatchingCount.load(std::memory_order_seq_cst) == 0) {
+			for(auto list : retiredList) {
+				delete list;
+			}
+			retiredList.clear();
+			hasRetired.store(false, std::memory_order_seq_cst);
+		}
+	}
+
+	static std::size_t getSelfInvokingCount(const Node * node) {
+		std::size_t count = 0;
+		for(DispatchFrame * frame = getTopFrame(); frame != nullptr; frame = frame->previous) {
+			if(frame->node == node) {
+				++count;
+			}
+		}
+		return count;
+	}
+
+	static DispatchFrame *& getTopFrame() {
+		static thread_local DispatchFrame * frame = nullptr;
+		return frame;
+	}
+
+private:
+	mutable std::mutex mutex;
+	std::atomic<const NodeList *> current;
+	mutable std::vector<const NodeList *> retiredList;
+	mutable std::atomic<bool> hasRetired;
+	mutable std::atomic<std::size_t> dispatchingCount;
+};
+
+
+} // namespace accessorpp
+
+#endif
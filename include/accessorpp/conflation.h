@@ -0,0 +1,169 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_CONFLATION_H_305817262894
+#define ACCESSORPP_CONFLATION_H_305817262894
+
+#include <atomic>
+#include <cstddef>
+
+namespace accessorpp {
+
+template <typename T>
+class ConflationSet;
+
+// ConflatedCallback is used as the OnChangedCallback policy.
+// It doesn't invoke any listener, it only records the latest value and marks the
+// accessor dirty in the attached ConflationSet. The consumer drains the set.
+template <typename T>
+class ConflatedCallback
+{
+public:
+	using ValueType = T;
+
+public:
+	ConflatedCallback()
+		:
+			conflationSet(nullptr),
+			tag(nullptr),
+			next(nullptr),
+			dirty(false),
+			valueLock(),
+			value()
+	{
+		valueLock.clear();
+	}
+
+	ConflatedCallback(const ConflatedCallback &) = delete;
+	ConflatedCallback & operator = (const ConflatedCallback &) = delete;
+
+	// Must be called before the accessor is set from any thread.
+	void attach(ConflationSet<T> & set, void * newTag = nullptr) {
+		conflationSet = &set;
+		tag = newTag;
+	}
+
+	void * getTag() const {
+		return tag;
+	}
+
+	void operator () (const T & newValue) {
+		if(conflationSet == nullptr) {
+			return;
+		}
+
+		lockValue();
+		value = newValue;
+		unlockValue();
+
+		if(! dirty.exchange(true, std::memory_order_acq_rel)) {
+			conflationSet->push(this);
+		}
+	}
+
+private:
+	T loadValue() {
+		lockValue();
+		T result(value);
+		unlockValue();
+		return result;
+	}
+
+	void lockValue() {
+		while(valueLock.test_and_set(std::memory_order_acquire)) {
+		}
+	}
+
+	void unlockValue() {
+		valueLock.clear(std::memory_order_release);
+	}
+
+private:
+	ConflationSet<T> * conflationSet;
+	void * tag;
+	ConflatedCallback * next;
+	std::atomic<bool> dirty;
+	std::atomic_flag valueLock;
+	T value;
+
+	friend class ConflationSet<T>;
+};
+
+// ConflationSet holds the dirty accessors which use ConflatedCallback.
+// Any number of threads can set the accessors, only one thread can drain the set.
+// An accessor is in the set at most once, so the set never grows beyond the
+// number of attached accessors.
+template <typename T>
+class ConflationSet
+{
+public:
+	using Callback = ConflatedCallback<T>;
+
+public:
+	ConflationSet()
+		: head(nullptr)
+	{
+	}
+
+	ConflationSet(const ConflationSet &) = delete;
+	ConflationSet & operator = (const ConflationSet &) = delete;
+
+	bool empty() const {
+		return head.load(std::memory_order_acquire) == nullptr;
+	}
+
+	// Invoke func(void * tag, const T & latestValue) for each changed accessor,
+	// in the order they became dirty. Return the number of accessors drained.
+	template <typename F>
+	std::size_t drain(F && func) {
+		Callback * node = head.exchange(nullptr, std::memory_order_acquire);
+
+		// The pushed list is LIFO, reverse it.
+		Callback * reversed = nullptr;
+		while(node != nullptr) {
+			Callback * next = node->next;
+			node->next = reversed;
+			reversed = node;
+			node = next;
+		}
+
+		std::size_t count = 0;
+		while(reversed != nullptr) {
+			Callback * current = reversed;
+			// Read next before clearing dirty, after that the producer may push current again.
+			reversed = current->next;
+			current->dirty.exchange(false, std::memory_order_acq_rel);
+			func(current->tag, current->loadValue());
+			++count;
+		}
+		return count;
+	}
+
+private:
+	void push(Callback * node) {
+		Callback * oldHead = head.load(std::memory_order_relaxed);
+		do {
+			node->next = oldHead;
+		} while(! head.compare_exchange_weak(oldHead, node, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+private:
+	std::atomic<Callback *> head;
+
+	friend class ConflatedCallback<T>;
+};
+
+
+} // namespace accessorpp
+
+#endif
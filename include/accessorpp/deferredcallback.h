@@ -0,0 +1,188 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_DEFERREDCALLBACK_H_760294815327
+#define ACCESSORPP_DEFERREDCALLBACK_H_760294815327
+
+#include "accessorpp/error.h"
+#include "accessorpp/internal/typeutil_i.h"
+
+#include <atomic>
+#include <functional>
+#include <deque>
+#include <type_traits>
+#include <cstddef>
+
+namespace accessorpp {
+
+namespace private_ {
+
+struct DeferredTask
+{
+	// The DeferredCallback which queued the task, nullptr if it's destroyed.
+	const void * owner;
+	std::size_t depth;
+	std::function<void ()> invoke;
+};
+
+// The work queue of the current thread.
+struct DeferredDispatchState
+{
+	std::deque<DeferredTask> taskQueue;
+	// The depth of the running notification, the outermost one is 0.
+	std::size_t depth;
+	bool dispatching;
+};
+
+inline DeferredDispatchState & getDeferredDispatchState()
+{
+	thread_local DeferredDispatchState state { {}, 0, false };
+	return state;
+}
+
+template <typename Dummy>
+struct DeferredDispatchSettings
+{
+	static std::atomic<std::size_t> maxCascadeDepth;
+};
+
+template <typename Dummy>
+std::atomic<std::size_t> DeferredDispatchSettings<Dummy>::maxCascadeDepth(1000);
+
+// Ends the dispatching even if a callback throws, the pending notifications are discarded.
+class DeferredDispatchScope
+{
+public:
+	explicit DeferredDispatchScope(DeferredDispatchState & dispatchState)
+		: state(dispatchState)
+	{
+		state.dispatching = true;
+		state.depth = 0;
+	}
+
+	~DeferredDispatchScope() {
+		state.taskQueue.clear();
+		state.depth = 0;
+		state.dispatching = false;
+	}
+
+	DeferredDispatchScope(const DeferredDispatchScope &) = delete;
+	DeferredDispatchScope & operator = (const DeferredDispatchScope &) = delete;
+
+private:
+	DeferredDispatchState & state;
+};
+
+} // namespace private_
+
+// The settings and the state of the deferred dispatching shared by all DeferredCallback.
+class DeferredDispatch
+{
+public:
+	// A notification queued deeper than the maximum cascade depth is dropped,
+	// and ErrorCode::cascadeTooDeep is passed to the ErrorHandler of the DeferredCallback.
+	static void setMaxCascadeDepth(const std::size_t depth) {
+		private_::DeferredDispatchSettings<void>::maxCascadeDepth.store(depth, std::memory_order_relaxed);
+	}
+
+	static std::size_t getMaxCascadeDepth() {
+		return private_::DeferredDispatchSettings<void>::maxCascadeDepth.load(std::memory_order_relaxed);
+	}
+
+	// Whether the current thread is invoking a DeferredCallback.
+	static bool isDispatching() {
+		return private_::getDeferredDispatchState().dispatching;
+	}
+
+	// The depth of the running notification on the current thread, the outermost one is 0.
+	static std::size_t getDepth() {
+		return private_::getDeferredDispatchState().depth;
+	}
+
+	// The queued notifications of the current thread.
+	static std::size_t getPendingCount() {
+		return private_::getDeferredDispatchState().taskQueue.size();
+	}
+};
+
+// DeferredCallback wraps a callback type, such as std::function or eventpp::CallbackList,
+// and is used as the OnChangedCallback policy.
+// If a listener sets an accessor which uses DeferredCallback, the notification of that set
+// is queued to the work queue of the current thread instead of recursing, and it's invoked
+// after the current listeners return. So a cascade of sets, including a cycle such as
+// A sets B and B sets A, runs in a loop with bounded stack usage, breadth first.
+template <typename CallbackType, typename ErrorHandler = DefaultErrorHandler>
+class DeferredCallback : public CallbackType
+{
+public:
+	DeferredCallback()
+		: CallbackType()
+	{
+	}
+
+	DeferredCallback(const DeferredCallback &) = delete;
+	DeferredCallback & operator = (const DeferredCallback &) = delete;
+
+	using CallbackType::operator =;
+
+	// The queued notifications of this callback are dropped.
+	~DeferredCallback() {
+		private_::DeferredDispatchState & state = private_::getDeferredDispatchState();
+		for(private_::DeferredTask & task : state.taskQueue) {
+			if(task.owner == this) {
+				task.owner = nullptr;
+			}
+		}
+	}
+
+	template <typename ...A>
+	auto operator () (const A & ...args)
+		-> typename std::enable_if<private_::CanInvoke<CallbackType, const A & ...>::value>::type
+	{
+		private_::DeferredDispatchState & state = private_::getDeferredDispatchState();
+		if(state.dispatching) {
+			// Re-entered from a listener, queue the notification.
+			const std::size_t depth = state.depth + 1;
+			if(depth > DeferredDispatch::getMaxCascadeDepth()) {
+				private_::handleError<ErrorHandler>(ErrorCode::cascadeTooDeep);
+				return;
+			}
+			state.taskQueue.push_back({ this, depth, [this, args...]() {
+				this->invokeNow(args...);
+			} });
+			return;
+		}
+
+		const private_::DeferredDispatchScope scope(state);
+		invokeNow(args...);
+		while(! state.taskQueue.empty()) {
+			private_::DeferredTask task = std::move(state.taskQueue.front());
+			state.taskQueue.pop_front();
+			if(task.owner != nullptr) {
+				state.depth = task.depth;
+				task.invoke();
+			}
+		}
+	}
+
+private:
+	template <typename ...A>
+	void invokeNow(const A & ...args) {
+		static_cast<CallbackType &>(*this)(args...);
+	}
+};
+
+
+} // namespace accessorpp
+
+#endif
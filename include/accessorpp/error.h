@@ -0,0 +1,246 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_ERROR_H_495028316740
+#define ACCESSORPP_ERROR_H_495028316740
+
+#include "accessorpp/compiler.h"
+#include "internal/typeutil_i.h"
+
+#include <cstdlib>
+#include <type_traits>
+#include <stdexcept>
+#include <functional>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+namespace accessorpp {
+
+enum class ErrorCode
+{
+	ok,
+	// Set to a read-only accessor.
+	readOnly,
+	// Get from an accessor without getter.
+	emptyGetter,
+	// Use an accessor with a VersionedSnapshot of another object.
+	foreignAccessor,
+	// A DeferredCallback notification exceeds the maximum cascade depth.
+	cascadeTooDeep
+};
+
+inline const char * getErrorMessage(const ErrorCode code)
+{
+	switch(code) {
+	case ErrorCode::ok:
+		return "No error.";
+
+	case ErrorCode::readOnly:
+		return "Can't set to read-only accessor.";
+
+	case ErrorCode::emptyGetter:
+		return "The accessor doesn't have getter.";
+
+	case ErrorCode::foreignAccessor:
+		return "The accessor doesn't belong to the snapshot.";
+
+	case ErrorCode::cascadeTooDeep:
+		return "The cascade of the deferred callbacks is too deep.";
+	}
+	return "Unknown error.";
+}
+
+// The ErrorHandler policy decides what happens on an error. It's a class with a static function
+// "void onError(ErrorCode code)". If onError returns, set does nothing,
+// the errors which can't continue, such as getting from an empty getter, call std::abort.
+
+// Throw std::logic_error, or std::bad_function_call for ErrorCode::emptyGetter.
+// onError is a template, so it's only compiled if it's used. It can't be used when exceptions
+// are disabled, use AbortOnError or another handler via the ErrorHandler policy,
+// or ACCESSORPP_DEFAULT_ERROR_HANDLER.
+struct ThrowOnError
+{
+	template <typename Dummy = void>
+	static void onError(const ErrorCode code) {
+#ifdef ACCESSORPP_NO_EXCEPTIONS
+		static_assert(sizeof(Dummy *) == 0,
+			"ThrowOnError can't be used when exceptions are disabled. "
+			"Set the ErrorHandler policy, or define ACCESSORPP_DEFAULT_ERROR_HANDLER in every translation unit."
+		);
+		(void)code;
+#else
+		if(code == ErrorCode::emptyGetter) {
+			throw std::bad_function_call();
+		}
+		throw std::logic_error(getErrorMessage(code));
+#endif
+	}
+};
+
+struct AbortOnError
+{
+	static void onError(const ErrorCode /*code*/) {
+		std::abort();
+	}
+};
+
+// Ignore the errors. It's useful with Accessor::trySet which returns the error code.
+struct IgnoreError
+{
+	static void onError(const ErrorCode /*code*/) {
+	}
+};
+
+// The default handler is the same in all translation units, no matter whether exceptions are enabled,
+// otherwise the accessors with the default policies would be different classes under the same name.
+// To change it, define ACCESSORPP_DEFAULT_ERROR_HANDLER to the handler type, such as
+// -DACCESSORPP_DEFAULT_ERROR_HANDLER=accessorpp::AbortOnError, in every translation unit
+// of the program, including src/instances.cpp if it's used.
+#ifdef ACCESSORPP_DEFAULT_ERROR_HANDLER
+using DefaultErrorHandler = ACCESSORPP_DEFAULT_ERROR_HANDLER;
+#else
+using DefaultErrorHandler = ThrowOnError;
+#endif
+
+// The ExceptionPolicy decides how the exceptions thrown by the user functions are handled where the library
+// must finish its own work first, such as a listener running in the thread pool, or a transaction body.
+// It's a template parameter instead of a switch on ACCESSORPP_NO_EXCEPTIONS, because the same inline
+// functions may be compiled with and without exceptions in different translation units of one program.
+
+// Catch the exceptions and rethrow them where the caller can handle them. It's the default.
+// It can't be used when exceptions are disabled.
+struct CaptureExceptions {};
+
+// The user functions never throw, nothing is caught. Use it when exceptions are disabled.
+struct NoExceptions {};
+
+// The same as DefaultErrorHandler, ACCESSORPP_DEFAULT_EXCEPTION_POLICY must have the same value
+// in every translation unit.
+#ifdef ACCESSORPP_DEFAULT_EXCEPTION_POLICY
+using DefaultExceptionPolicy = ACCESSORPP_DEFAULT_EXCEPTION_POLICY;
+#else
+using DefaultExceptionPolicy = CaptureExceptions;
+#endif
+
+namespace private_ {
+
+// Keep the first exception thrown by the functions invoked through it,
+// so it can be rethrown later, or in another thread.
+template <typename ExceptionPolicy>
+class FirstException
+{
+#ifdef ACCESSORPP_NO_EXCEPTIONS
+	static_assert(sizeof(ExceptionPolicy *) == 0,
+		"CaptureExceptions can't be used when exceptions are disabled. "
+		"Use the NoExceptions policy, or define ACCESSORPP_DEFAULT_EXCEPTION_POLICY in every translation unit."
+	);
+#else
+public:
+	FirstException() : mutex(), exception() {
+	}
+
+	template <typename F>
+	void invoke(F && func) {
+		try {
+			func();
+		}
+		catch(...) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if(! exception) {
+				exception = std::current_exception();
+			}
+		}
+	}
+
+	// Rethrow the kept exception, if any, and forget it.
+	void rethrow() {
+		std::exception_ptr kept;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			std::swap(kept, exception);
+		}
+		if(kept) {
+			std::rethrow_exception(kept);
+		}
+	}
+
+private:
+	std::mutex mutex;
+	std::exception_ptr exception;
+#endif
+};
+
+template <>
+class FirstException <NoExceptions>
+{
+public:
+	template <typename F>
+	void invoke(F && func) {
+		func();
+	}
+
+	void rethrow() {
+	}
+};
+
+template <typename PoliciesType>
+struct GetErrorHandler
+{
+	using Type = typename SelectErrorHandler<PoliciesType, HasTypeErrorHandler<PoliciesType>::value, DefaultErrorHandler>::Type;
+};
+
+template <typename ErrorHandler>
+ACCESSORPP_COLD void handleError(const ErrorCode code)
+{
+	ErrorHandler::onError(code);
+}
+
+// For the errors which can't continue.
+template <typename ErrorHandler>
+ACCESSORPP_COLD void handleFatalError(const ErrorCode code)
+{
+	ErrorHandler::onError(code);
+	std::abort();
+}
+
+template <typename T, typename Enabled = void>
+struct ErrorFallbackValue
+{
+	static T get() {
+		std::abort();
+	}
+};
+
+template <typename T>
+struct ErrorFallbackValue <T, typename std::enable_if<! std::is_reference<T>::value && std::is_default_constructible<T>::value>::type>
+{
+	static T get() {
+		return T();
+	}
+};
+
+// If the handler returns, a default constructed value is returned if possible, otherwise std::abort is called.
+template <typename T, typename ErrorHandler>
+ACCESSORPP_COLD T handleEmptyGetter()
+{
+	ErrorHandler::onError(ErrorCode::emptyGetter);
+	return ErrorFallbackValue<T>::get();
+}
+
+} // namespace private_
+
+
+} // namespace accessorpp
+
+#endif
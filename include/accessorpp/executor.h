@@ -0,0 +1,163 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_EXECUTOR_H_618350927461
+#define ACCESSORPP_EXECUTOR_H_618350927461
+
+#include "accessorpp/error.h"
+#include "accessorpp/internal/typeutil_i.h"
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <type_traits>
+
+namespace accessorpp {
+
+// ExecutorCallback wraps a callback type, such as std::function or eventpp::CallbackList,
+// and is used as the OnChangingCallback or OnChangedCallback policy.
+// When an executor is set, the arguments are copied and the invocation is posted
+// to the executor instead of running in Accessor::set.
+// The invocations of one callback run in the order they were posted, one at a time,
+// even if the executor runs tasks on multiple threads.
+// With CaptureExceptions, the exceptions thrown by the posted invocations are rethrown by waitForIdle,
+// with NoExceptions, the callback must not throw.
+template <typename CallbackType, typename ExceptionPolicy = DefaultExceptionPolicy>
+class ExecutorCallback : public CallbackType
+{
+public:
+	using Task = std::function<void ()>;
+	using Executor = std::function<void (Task)>;
+
+public:
+	ExecutorCallback()
+		:
+			CallbackType(),
+			executor(),
+			mutex(),
+			idle(),
+			taskQueue(),
+			running(false),
+			firstException()
+	{
+	}
+
+	ExecutorCallback(const ExecutorCallback &) = delete;
+	ExecutorCallback & operator = (const ExecutorCallback &) = delete;
+
+	using CallbackType::operator =;
+
+	// Wait for the posted invocations to finish. The exception of the posted invocations,
+	// if any, is discarded.
+	~ExecutorCallback() {
+		waitForPending();
+	}
+
+	// E must have member function post(std::function<void ()>), such as ThreadPool.
+	// The executor must outlive the callback.
+	template <typename E>
+	void setExecutor(E & newExecutor) {
+		executor = [&newExecutor](Task task) {
+			newExecutor.post(std::move(task));
+		};
+	}
+
+	void setExecutor(Executor newExecutor) {
+		executor = std::move(newExecutor);
+	}
+
+	// Without executor, the callback is invoked in Accessor::set.
+	void clearExecutor() {
+		executor = Executor();
+	}
+
+	// If any posted invocation threw, the first exception since the last waitForIdle is rethrown.
+	void waitForIdle() {
+		waitForPending();
+		firstException.rethrow();
+	}
+
+	template <typename ...A>
+	auto operator () (const A & ...args)
+		-> typename std::enable_if<private_::CanInvoke<CallbackType, const A & ...>::value>::type
+	{
+		if(! executor) {
+			invokeNow(args...);
+			return;
+		}
+
+		bool needSchedule = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			taskQueue.push_back([this, args...]() {
+				this->invokeNow(args...);
+			});
+			if(! running) {
+				running = true;
+				needSchedule = true;
+			}
+		}
+		if(needSchedule) {
+			executor([this]() {
+				this->drain();
+			});
+		}
+	}
+
+private:
+	template <typename ...A>
+	void invokeNow(const A & ...args) {
+		static_cast<CallbackType &>(*this)(args...);
+	}
+
+	void waitForPending() {
+		std::unique_lock<std::mutex> lock(mutex);
+		idle.wait(lock, [this]() {
+			return ! running;
+		});
+	}
+
+	// A throwing invocation doesn't stop the draining, otherwise running is never reset
+	// and waitForIdle never returns.
+	void drain() {
+		for(;;) {
+			Task task;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if(taskQueue.empty()) {
+					running = false;
+					// Notify under the lock, the callback may be destroyed as soon as the lock is released.
+					idle.notify_all();
+					return;
+				}
+				task = std::move(taskQueue.front());
+				taskQueue.pop_front();
+			}
+			firstException.invoke(task);
+		}
+	}
+
+private:
+	Executor executor;
+	std::mutex mutex;
+	std::condition_variable idle;
+	std::deque<Task> taskQueue;
+	bool running;
+	private_::FirstException<ExceptionPolicy> firstException;
+};
+
+
+} // namespace accessorpp
+
+#endif
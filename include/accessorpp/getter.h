@@ -16,10 +16,11 @@
 
 #include "internal/typeutil_i.h"
 #include "accessorpp/common.h"
+#include "accessorpp/error.h"
 
 #include <functional>
 #include <type_traits>
-#include <ostream> 
+#include <iosfwd>
 
 namespace accessorpp {
 
@@ -33,6 +34,88 @@ protected:
 	}
 };
 
+// The functions stored in Getter. They don't depend on the policies, so the Getters
+// with different policies share the same std::function instantiations.
+template <typename Type, typename ErrorHandler>
+struct EmptyGetterFunc
+{
+	Type operator () (const void *) const {
+		return handleEmptyGetter<Type, ErrorHandler>();
+	}
+};
+
+template <typename Type, typename U>
+struct AddressGetterFunc
+{
+	Type operator () (const void *) const {
+		return (Type)*address;
+	}
+
+	const U * address;
+};
+
+template <typename Type, typename U, typename C>
+struct MemberGetterFunc
+{
+	Type operator () (const void *) const {
+		return (Type)(instance->*address);
+	}
+
+	const U C::* address;
+	const C * instance;
+};
+
+template <typename Type, typename U, typename C>
+struct InstanceMemberGetterFunc
+{
+	Type operator () (const void * instance) const {
+		return (Type)(static_cast<const C *>(instance)->*address);
+	}
+
+	const U C::* address;
+};
+
+template <typename Type>
+struct ValueGetterFunc
+{
+	Type operator () (const void *) const {
+		return value;
+	}
+
+	typename GetUnderlyingType<Type>::Type value;
+};
+
+template <typename Type, typename F>
+struct CallableGetterFunc
+{
+	Type operator () (const void *) const {
+		return (Type)func();
+	}
+
+	F func;
+};
+
+template <typename Type, typename F, typename C>
+struct MemberFunctionGetterFunc
+{
+	Type operator () (const void *) const {
+		return (Type)((instance->*func)());
+	}
+
+	F func;
+	C * instance;
+};
+
+template <typename Type, typename F>
+struct InstanceMemberFunctionGetterFunc
+{
+	Type operator () (const void * instance) const {
+		return (Type)((static_cast<const typename CallableTypeChecker<F>::ClassType *>(instance)->*func)());
+	}
+
+	F func;
+};
+
 } // namespace private_
 
 template <typename Type_, typename PoliciesType = DefaultPolicies>
@@ -43,23 +126,26 @@ public:
 	using Type = Type_;
 	using ValueType = typename private_::GetUnderlyingType<Type>::Type;
 
+private:
+	using GetterFunc = std::function<Type (const void *)>;
+
 public:
 	Getter()
-		: getterFunc()
+		: getterFunc(private_::EmptyGetterFunc<Type, typename private_::GetErrorHandler<PoliciesType>::Type>())
 	{
 	}
 
 	template <typename U>
 	explicit Getter(const U * address,
 		typename std::enable_if<std::is_convertible<U, ValueType>::value>::type * = nullptr)
-		: getterFunc([address](const void *)->Type { return (Type)*address; })
+		: getterFunc(private_::AddressGetterFunc<Type, U> { address })
 	{
 	}
 
 	template <typename U, typename C>
 	Getter(const U C::* address, const C * instance,
 		typename std::enable_if<std::is_convertible<U, ValueType>::value>::type * = nullptr)
-		: getterFunc([address, instance](const void *)->Type { return (Type)(instance->*address); })
+		: getterFunc(private_::MemberGetterFunc<Type, U, C> { address, instance })
 	{
 		this->template setClassType<C>();
 	}
@@ -67,20 +153,23 @@ public:
 	template <typename U, typename C>
 	Getter(const U C::* address,
 		typename std::enable_if<std::is_convertible<U, ValueType>::value>::type * = nullptr)
-		: getterFunc([address](const void * instance)->Type { return (Type)(static_cast<const C *>(instance)->*address); })
+		: getterFunc(private_::InstanceMemberGetterFunc<Type, U, C> { address })
 	{
 		this->template setClassType<C>();
 	}
 
 	explicit Getter(const Type & value)
-		: getterFunc([value](const void *)->Type { return value; })
+		: getterFunc(private_::ValueGetterFunc<Type> { value })
 	{
 	}
 
 	template <typename F>
 	explicit Getter(F func,
 		typename std::enable_if<private_::CanInvoke<F>::value>::type * = nullptr)
-		: getterFunc([func](const void *)->Type { return (Type)func(); })
+		: getterFunc(private_::isEmptyCallable(func)
+			? GetterFunc(private_::EmptyGetterFunc<Type, typename private_::GetErrorHandler<PoliciesType>::Type>())
+			: GetterFunc(private_::CallableGetterFunc<Type, F> { func })
+		)
 	{
 	}
 
@@ -90,7 +179,7 @@ public:
 			private_::CallableTypeChecker<F>::isClassMember
 			&& std::is_convertible<typename private_::CallableTypeChecker<F>::ResultType, ValueType>::value
 		>::type * = nullptr)
-		: getterFunc([func, instance](const void *)->Type { return (Type)((instance->*func)()); })
+		: getterFunc(private_::MemberFunctionGetterFunc<Type, F, C> { func, instance })
 	{
 		this->template setClassType<typename private_::CallableTypeChecker<F>::ClassType>();
 	}
@@ -101,9 +190,7 @@ public:
 			private_::CallableTypeChecker<F>::isClassMember
 			&& std::is_convertible<typename private_::CallableTypeChecker<F>::ResultType, ValueType>::value
 		>::type * = nullptr)
-		: getterFunc([func](const void * instance)->Type {
-			return (Type)((static_cast<const typename private_::CallableTypeChecker<F>::ClassType *>(instance)->*func)());
-		})
+		: getterFunc(private_::InstanceMemberFunctionGetterFunc<Type, F> { func })
 	{
 		this->template setClassType<typename private_::CallableTypeChecker<F>::ClassType>();
 	}
@@ -137,7 +224,7 @@ public:
 	}
 
 private:
-	std::function<Type (const void *)> getterFunc;
+	GetterFunc getterFunc;
 };
 
 template <typename T>
@@ -0,0 +1,58 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_INSTANCES_H_730418562097
+#define ACCESSORPP_INSTANCES_H_730418562097
+
+#include "accessorpp/accessorcore.h"
+
+#include <string>
+
+// Including this header declares the common accessors as explicitly instantiated
+// elsewhere, then the program must link the instances compiled from src/instances.cpp.
+// The macros can be used to declare and instantiate the accessors with other types and policies.
+// Setter doesn't depend on the policies, it's instantiated once for each type.
+
+#define ACCESSORPP_EXTERN_ACCESSOR(Type, Policies) \
+	extern template class accessorpp::Getter<Type, Policies>; \
+	extern template class accessorpp::private_::AccessorRoot<Type, Policies>; \
+	extern template class accessorpp::private_::AccessorBase<Type, accessorpp::private_::ResolvedPolicies<Policies>::Storage, Policies>; \
+	extern template class accessorpp::Accessor<Type, Policies>;
+
+#define ACCESSORPP_INSTANTIATE_ACCESSOR(Type, Policies) \
+	template class accessorpp::Getter<Type, Policies>; \
+	template class accessorpp::private_::AccessorRoot<Type, Policies>; \
+	template class accessorpp::private_::AccessorBase<Type, accessorpp::private_::ResolvedPolicies<Policies>::Storage, Policies>; \
+	template class accessorpp::Accessor<Type, Policies>;
+
+#define ACCESSORPP_EXTERN_SETTER(Type) \
+	extern template class accessorpp::Setter<Type>;
+
+#define ACCESSORPP_INSTANTIATE_SETTER(Type) \
+	template class accessorpp::Setter<Type>;
+
+// The types instantiated in src/instances.cpp, all with DefaultPolicies.
+#define ACCESSORPP_COMMON_INSTANCE_TYPES(M) \
+	M(int) \
+	M(double) \
+	M(bool) \
+	M(std::string)
+
+#define ACCESSORPP_EXTERN_COMMON_INSTANCE(Type) \
+	ACCESSORPP_EXTERN_SETTER(Type) \
+	ACCESSORPP_EXTERN_ACCESSOR(Type, accessorpp::DefaultPolicies)
+
+ACCESSORPP_COMMON_INSTANCE_TYPES(ACCESSORPP_EXTERN_COMMON_INSTANCE)
+
+#endif
+
@@ -0,0 +1,279 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_INSTRUMENTATION_H_913640285172
+#define ACCESSORPP_INSTRUMENTATION_H_913640285172
+
+#include "accessorpp/accessorcore.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <ostream>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+namespace accessorpp {
+
+class AccessCounterRegistry;
+
+struct AccessCounts
+{
+	std::string name;
+	std::uint64_t getCount;
+	std::uint64_t setCount;
+	// The sets rejected because the accessor is read-only.
+	std::uint64_t suppressedSetCount;
+	// The invocations of OnChangingCallback and OnChangedCallback.
+	std::uint64_t callbackCount;
+
+	std::uint64_t getTotalCount() const {
+		return getCount + setCount + suppressedSetCount + callbackCount;
+	}
+};
+
+namespace private_ {
+
+class AccessCounterSource
+{
+public:
+	virtual ~AccessCounterSource() {
+	}
+
+protected:
+	// Called by AccessCounterRegistry with the registry locked.
+	virtual AccessCounts doGetAccessCounts() const = 0;
+
+	friend class accessorpp::AccessCounterRegistry;
+};
+
+// Each thread uses the shard of its index, the indexes are assigned round robin.
+inline std::size_t getAccessCounterThreadIndex()
+{
+	static std::atomic<std::size_t> nextIndex(0);
+	thread_local std::size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+} // namespace private_
+
+// All living accessors using the counting instrumentations register themselves here.
+class AccessCounterRegistry
+{
+public:
+	static AccessCounterRegistry & getInstance() {
+		static AccessCounterRegistry registry;
+		return registry;
+	}
+
+	std::vector<AccessCounts> getAccessCountsList() const {
+		std::vector<AccessCounts> result;
+		std::lock_guard<std::mutex> lock(mutex);
+		result.reserve(sourceSet.size());
+		for(const private_::AccessCounterSource * source : sourceSet) {
+			result.push_back(source->doGetAccessCounts());
+		}
+		return result;
+	}
+
+	// Return at most count accessors which have the most accesses, the most accessed is the first.
+	std::vector<AccessCounts> getTopList(const std::size_t count) const {
+		std::vector<AccessCounts> result = getAccessCountsList();
+		const auto compare = [](const AccessCounts & a, const AccessCounts & b) {
+			return a.getTotalCount() > b.getTotalCount();
+		};
+		if(count < result.size()) {
+			std::partial_sort(result.begin(), result.begin() + count, result.end(), compare);
+			result.resize(count);
+		}
+		else {
+			std::sort(result.begin(), result.end(), compare);
+		}
+		return result;
+	}
+
+	void dumpTopList(std::ostream & stream, const std::size_t count) const {
+		for(const AccessCounts & counts : getTopList(count)) {
+			stream << (counts.name.empty() ? "(unnamed)" : counts.name)
+				<< ": total=" << counts.getTotalCount()
+				<< " get=" << counts.getCount
+				<< " set=" << counts.setCount
+				<< " suppressedSet=" << counts.suppressedSetCount
+				<< " callback=" << counts.callbackCount
+				<< '\n';
+		}
+	}
+
+private:
+	AccessCounterRegistry() : mutex(), sourceSet() {
+	}
+
+	void add(const private_::AccessCounterSource * source) {
+		std::lock_guard<std::mutex> lock(mutex);
+		sourceSet.insert(source);
+	}
+
+	void remove(const private_::AccessCounterSource * source) {
+		std::lock_guard<std::mutex> lock(mutex);
+		sourceSet.erase(source);
+	}
+
+	template <typename F>
+	void withLock(F && func) {
+		std::lock_guard<std::mutex> lock(mutex);
+		func();
+	}
+
+private:
+	mutable std::mutex mutex;
+	std::unordered_set<const private_::AccessCounterSource *> sourceSet;
+
+	template <std::size_t ShardCount>
+	friend class BasicCountAccesses;
+};
+
+// The Instrumentation policy which counts the accesses with relaxed atomic counters.
+// ShardCount > 1 spreads the counters to shards on separate cache lines, each thread
+// uses one shard, so the threads accessing the same accessor don't contend on the counters.
+template <std::size_t ShardCount>
+class BasicCountAccesses : public private_::AccessCounterSource
+{
+private:
+	static_assert(ShardCount > 0, "ShardCount must be positive.");
+
+	struct Counters
+	{
+		std::atomic<std::uint64_t> getCount;
+		std::atomic<std::uint64_t> setCount;
+		std::atomic<std::uint64_t> suppressedSetCount;
+		std::atomic<std::uint64_t> callbackCount;
+	};
+
+	// The counters of two shards are never in the same cache line.
+	struct PaddedCounters : Counters
+	{
+		char padding[64];
+	};
+
+	using Shard = typename std::conditional<(ShardCount > 1), PaddedCounters, Counters>::type;
+
+public:
+	BasicCountAccesses() : name(), shardList() {
+		clear();
+		AccessCounterRegistry::getInstance().add(this);
+	}
+
+	// The counts are not copied, the name is.
+	BasicCountAccesses(const BasicCountAccesses & other) : name(other.getName()), shardList() {
+		clear();
+		AccessCounterRegistry::getInstance().add(this);
+	}
+
+	~BasicCountAccesses() {
+		AccessCounterRegistry::getInstance().remove(this);
+	}
+
+	BasicCountAccesses & operator = (const BasicCountAccesses &) {
+		return *this;
+	}
+
+	// The name identifies the accessor in AccessCounterRegistry.
+	void setName(const std::string & newName) {
+		AccessCounterRegistry::getInstance().withLock([this, &newName]() {
+			name = newName;
+		});
+	}
+
+	std::string getName() const {
+		std::string result;
+		AccessCounterRegistry::getInstance().withLock([this, &result]() {
+			result = name;
+		});
+		return result;
+	}
+
+	AccessCounts getAccessCounts() const {
+		AccessCounts counts {};
+		AccessCounterRegistry::getInstance().withLock([this, &counts]() {
+			counts = doGetAccessCounts();
+		});
+		return counts;
+	}
+
+	void clear() {
+		for(Shard & shard : shardList) {
+			shard.getCount.store(0, std::memory_order_relaxed);
+			shard.setCount.store(0, std::memory_order_relaxed);
+			shard.suppressedSetCount.store(0, std::memory_order_relaxed);
+			shard.callbackCount.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	// The hooks called by Accessor.
+	void onGet() const {
+		increase(&Counters::getCount);
+	}
+
+	void onSetBegin() const {
+		increase(&Counters::setCount);
+	}
+
+	void onSetEnd() const {
+	}
+
+	void onSuppressedSet() const {
+		increase(&Counters::suppressedSetCount);
+	}
+
+	void onCallbackBegin() const {
+		increase(&Counters::callbackCount);
+	}
+
+	void onCallbackEnd() const {
+	}
+
+protected:
+	AccessCounts doGetAccessCounts() const override {
+		AccessCounts counts { name, 0, 0, 0, 0 };
+		for(const Shard & shard : shardList) {
+			counts.getCount += shard.getCount.load(std::memory_order_relaxed);
+			counts.setCount += shard.setCount.load(std::memory_order_relaxed);
+			counts.suppressedSetCount += shard.suppressedSetCount.load(std::memory_order_relaxed);
+			counts.callbackCount += shard.callbackCount.load(std::memory_order_relaxed);
+		}
+		return counts;
+	}
+
+private:
+	// The counts are statistics only, so relaxed order is enough.
+	void increase(std::atomic<std::uint64_t> Counters::* counter) const {
+		Shard & shard = shardList[ShardCount > 1 ? private_::getAccessCounterThreadIndex() % ShardCount : 0];
+		(shard.*counter).fetch_add(1, std::memory_order_relaxed);
+	}
+
+private:
+	// Guarded by the registry mutex.
+	std::string name;
+	mutable Shard shardList[ShardCount];
+};
+
+using CountAccesses = BasicCountAccesses<1>;
+using CountAccessesPerThread = BasicCountAccesses<16>;
+
+} // namespace accessorpp
+
+#endif
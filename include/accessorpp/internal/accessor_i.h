@@ -16,6 +16,71 @@
 
 namespace private_ {
 
+struct AccessorFriend;
+
+// All policies used by Accessor, resolved once per policies class.
+// Accessor and its bases use the members instead of evaluating the Select traits again.
+template <typename PoliciesType>
+struct ResolvedPolicies
+{
+	using Storage = typename SelectStorage<PoliciesType, HasTypeStorage<PoliciesType>::value, InternalStorage>::Type;
+	using OnChangingCallback = typename SelectOnChangingCallback<PoliciesType, HasTypeOnChangingCallback<PoliciesType>::value>::Type;
+	using OnChangedCallback = typename SelectOnChangedCallback<PoliciesType, HasTypeOnChangedCallback<PoliciesType>::value>::Type;
+	using CallbackData = typename SelectCallbackData<PoliciesType, HasTypeCallbackData<PoliciesType>::value>::Type;
+	using ErrorHandler = typename GetErrorHandler<PoliciesType>::Type;
+	using Instrumentation = typename SelectInstrumentation<PoliciesType, HasTypeInstrumentation<PoliciesType>::value, NoInstrumentation>::Type;
+
+	static constexpr bool internalStorage = std::is_same<Storage, InternalStorage>::value;
+	static constexpr bool literalStorage = std::is_same<Storage, LiteralStorage>::value;
+	static constexpr bool instrumented = ! std::is_same<Instrumentation, NoInstrumentation>::value;
+	static constexpr bool hasOnChangingCallback = ! std::is_void<OnChangingCallback>::value;
+	static constexpr bool hasOnChangedCallback = ! std::is_void<OnChangedCallback>::value;
+};
+
+// The instrumentation is a private base, so NoInstrumentation doesn't increase the size of Accessor.
+template <typename InstrumentationType>
+class InstrumentationHolder : private InstrumentationType
+{
+public:
+	constexpr const InstrumentationType & getInstrumentation() const {
+		return *this;
+	}
+
+	ACCESSORPP_CONSTEXPR14 InstrumentationType & getInstrumentation() {
+		return *this;
+	}
+};
+
+// Calls endFunction of the instrumentation when the scope ends, including when an exception is thrown.
+// If it's not enabled, it does nothing and is a literal type, so it can be used in constant expressions.
+template <typename InstrumentationType, void (InstrumentationType::*endFunction)() const, bool enabled>
+class InstrumentationScope
+{
+public:
+	constexpr explicit InstrumentationScope(const InstrumentationType &) {
+	}
+};
+
+template <typename InstrumentationType, void (InstrumentationType::*endFunction)() const>
+class InstrumentationScope <InstrumentationType, endFunction, true>
+{
+public:
+	explicit InstrumentationScope(const InstrumentationType & instrumentationToEnd)
+		: instrumentation(instrumentationToEnd)
+	{
+	}
+
+	~InstrumentationScope() {
+		(instrumentation.*endFunction)();
+	}
+
+	InstrumentationScope(const InstrumentationScope &) = delete;
+	InstrumentationScope & operator = (const InstrumentationScope &) = delete;
+
+private:
+	const InstrumentationType & instrumentation;
+};
+
 template <typename CallbackType>
 struct ChangeCallbackBase
 {
@@ -30,6 +95,58 @@ struct ChangeCallbackBase
 	CallbackType callback;
 };
 
+#ifdef ACCESSORPP_SUPPORT_STANDARD_17
+
+// The callback prototype is selected by if constexpr, which is cheaper to compile
+// than the overload resolution among the SFINAE overloads in the C++11 version.
+template <typename CallbackType, typename CallbackDataType>
+class ChangeCallback : protected ChangeCallbackBase <CallbackType>
+{
+protected:
+	template <typename ValueType>
+	void invokeCallback(
+			const ValueType & newValue
+		) {
+		invokeCallback(newValue, CallbackDataType());
+	}
+
+	template <typename ValueType>
+	void invokeCallback(
+			const ValueType & newValue,
+			const CallbackDataType & data
+		) {
+		if constexpr(CanInvoke<CallbackType, const ValueType &, const CallbackDataType &>::value) {
+			this->callback(newValue, data);
+		}
+		else if constexpr(CanInvoke<CallbackType, const ValueType &>::value) {
+			this->callback(newValue);
+		}
+		else {
+			this->callback();
+		}
+	}
+};
+
+template <typename CallbackType>
+class ChangeCallback <CallbackType, void> : protected ChangeCallbackBase <CallbackType>
+{
+protected:
+	template <typename ValueType, typename ...Data>
+	void invokeCallback(
+			const ValueType & newValue,
+			Data && ...
+		) {
+		if constexpr(CanInvoke<CallbackType, const ValueType &>::value) {
+			this->callback(newValue);
+		}
+		else {
+			this->callback();
+		}
+	}
+};
+
+#else
+
 template <typename CallbackType, typename CallbackDataType>
 class ChangeCallback : protected ChangeCallbackBase <CallbackType>
 {
@@ -120,16 +237,21 @@ private:
 	}
 };
 
+#endif
+
+// Tag makes the dummy bases of OnChangingCallback and OnChangedCallback different types,
+// so both can be placed at the same address and don't increase the size of Accessor.
+template <typename Tag>
 class DummyChangeCallback
 {
 protected:
 	template <typename ValueType>
-	void invokeCallback(const ValueType & /*newValue*/)
+	ACCESSORPP_CONSTEXPR14 void invokeCallback(const ValueType & /*newValue*/)
 	{
 	}
 
 	template <typename ValueType, typename Data>
-	void invokeCallback(const ValueType & /*newValue*/, Data &&)
+	ACCESSORPP_CONSTEXPR14 void invokeCallback(const ValueType & /*newValue*/, Data &&)
 	{
 	}
 
@@ -154,7 +276,7 @@ public:
 };
 
 template <typename CallbackDataType>
-class OnChangingCallback <void, CallbackDataType> : public DummyChangeCallback
+class OnChangingCallback <void, CallbackDataType> : public DummyChangeCallback<OnChangingCallback<void, CallbackDataType> >
 {
 };
 
@@ -177,7 +299,7 @@ public:
 };
 
 template <typename CallbackDataType>
-class OnChangedCallback <void, CallbackDataType> : public DummyChangeCallback
+class OnChangedCallback <void, CallbackDataType> : public DummyChangeCallback<OnChangedCallback<void, CallbackDataType> >
 {
 };
 
@@ -187,6 +309,7 @@ class AccessorRoot
 protected:
 	using GetterType = Getter<Type_, PoliciesType>;
 	using SetterType = Setter<Type_>;
+	using ErrorHandlerType = typename ResolvedPolicies<PoliciesType>::ErrorHandler;
 
 public:
 	AccessorRoot() noexcept
@@ -251,15 +374,42 @@ public:
 		return getter;
 	}
 
-	SetterType & getSetter() const {
+	const SetterType & getSetter() const {
 		return setter;
 	}
 
 protected:
-	void doCheckWritable() const {
+	using UnderlyingType = typename GetUnderlyingType<Type_>::Type;
+
+	// Return false if the accessor can't be set, the error is passed to the error handler.
+	bool doCheckWritable() const {
 		if(readOnly) {
-			throw std::logic_error("Can't set to read-only accessor.");
+			handleError<ErrorHandlerType>(ErrorCode::readOnly);
+			return false;
 		}
+		return true;
+	}
+
+	Type_ doGetValue(const void * instance) const {
+		return getter.get(instance);
+	}
+
+	void doSetValue(const UnderlyingType & newValue, void * instance) {
+		setter.set(newValue, instance);
+	}
+
+	// Read-modify-write via the getter and setter. The storages which can update
+	// the value in one step hide this function.
+	template <typename F, typename B, typename A>
+	void doUpdate(F && func, B && beforeWrite, A && afterWrite, void * instance) {
+		const UnderlyingType newValue = func(static_cast<const UnderlyingType &>(getter.get(instance)));
+		beforeWrite(newValue);
+		setter.set(newValue, instance);
+		afterWrite(newValue);
+	}
+
+	// Called when the getter or setter is replaced.
+	void doClearDirectAccess() {
 	}
 
 protected:
@@ -285,22 +435,25 @@ public:
 public:
 	AccessorBase(const ValueType & newValue = ValueType())
 		:
-			super(&AccessorBase::value, this, &AccessorBase::value, this),
-			value(newValue)
+			super(GetterType(&value), SetterType(&value)),
+			value(newValue),
+			directAccess(true)
 	{
 	}
 
 	AccessorBase(const AccessorBase & other)
 		:
-			super(&AccessorBase::value, this, &AccessorBase::value, this),
-			value(other.value)
+			super(GetterType(&value), SetterType(&value)),
+			value(other.value),
+			directAccess(true)
 	{
 	}
 
 	AccessorBase(AccessorBase && other)
 		:
 			super(static_cast<super &&>(other)),
-			value(std::move(other.value))
+			value(std::move(other.value)),
+			directAccess(false)
 	{
 	}
 
@@ -309,16 +462,18 @@ public:
 		:
 			super(std::forward<G>(getter),
 				std::forward<S>(setter)),
-			value(newValue)
+			value(newValue),
+			directAccess(false)
 	{
 	}
 
 	template <typename S>
 	AccessorBase(DefaultGetter, S && setter, const ValueType & newValue = ValueType())
 		:
-			super(GetterType(&AccessorBase::value, this),
+			super(GetterType(&value),
 				std::forward<S>(setter)),
-			value(newValue)
+			value(newValue),
+			directAccess(false)
 	{
 	}
 
@@ -326,16 +481,18 @@ public:
 	AccessorBase(G && getter, DefaultSetter, const ValueType & newValue = ValueType())
 		:
 			super(GetterType(std::forward<G>(getter)),
-				SetterType(&AccessorBase::value, this)),
-			value(newValue)
+				SetterType(&value)),
+			value(newValue),
+			directAccess(false)
 	{
 	}
 
 	AccessorBase(DefaultGetter, DefaultSetter, const ValueType & newValue = ValueType())
 		:
-			super(GetterType(&AccessorBase::value, this),
-				SetterType(&AccessorBase::value, this)),
-			value(newValue)
+			super(GetterType(&value),
+				SetterType(&value)),
+			value(newValue),
+			directAccess(true)
 	{
 	}
 
@@ -348,7 +505,8 @@ public:
 		:
 			super(std::forward<G>(getter), std::forward<IG>(getterInstance),
 				std::forward<S>(setter), std::forward<IS>(setterInstance)),
-			value(newValue)
+			value(newValue),
+			directAccess(false)
 	{
 	}
 
@@ -367,8 +525,33 @@ public:
 		value = newValue;
 	}
 
+	// True if the getter and setter access the value directly, then the value
+	// can be used without calling the getter and setter.
+	bool isDirectAccess() const {
+		return directAccess;
+	}
+
+protected:
+	template <typename F, typename B, typename A>
+	void doUpdate(F && func, B && beforeWrite, A && afterWrite, void * instance) {
+		if(! directAccess) {
+			super::doUpdate(std::forward<F>(func), std::forward<B>(beforeWrite), std::forward<A>(afterWrite), instance);
+			return;
+		}
+
+		ValueType newValue = func(static_cast<const ValueType &>(value));
+		beforeWrite(static_cast<const ValueType &>(newValue));
+		value = std::move(newValue);
+		afterWrite(static_cast<const ValueType &>(value));
+	}
+
+	void doClearDirectAccess() {
+		directAccess = false;
+	}
+
 private:
 	ValueType value;
+	bool directAccess;
 };
 
 template <typename Type_, typename PoliciesType>
@@ -385,6 +568,74 @@ public:
 	using super::super;
 };
 
+// LiteralStorage doesn't derive from AccessorRoot, it has neither getter nor setter,
+// so the accessor is a literal type if the value type is and the callbacks are void.
+template <typename Type_, typename PoliciesType>
+class AccessorBase <Type_, LiteralStorage, PoliciesType>
+{
+private:
+	using ValueType = typename std::remove_cv<typename std::remove_reference<Type_>::type>::type;
+
+	static_assert(! std::is_reference<Type_>::value, "LiteralStorage can't return reference.");
+
+public:
+	// Only for the type definitions in Accessor, LiteralStorage doesn't use them.
+	using GetterType = Getter<Type_, PoliciesType>;
+	using SetterType = Setter<Type_>;
+
+public:
+	constexpr AccessorBase(const ValueType & newValue = ValueType())
+		: value(newValue)
+	{
+	}
+
+	constexpr bool isReadOnly() const {
+		return false;
+	}
+
+	constexpr const ValueType & directGet() const {
+		return value;
+	}
+
+	ACCESSORPP_CONSTEXPR14 ValueType & directGet() {
+		return value;
+	}
+
+	ACCESSORPP_CONSTEXPR14 void directSet(const ValueType & newValue) {
+		value = newValue;
+	}
+
+	constexpr bool isDirectAccess() const {
+		return true;
+	}
+
+protected:
+	using UnderlyingType = ValueType;
+
+	constexpr bool doCheckWritable() const {
+		return true;
+	}
+
+	constexpr const ValueType & doGetValue(const void * /*instance*/) const {
+		return value;
+	}
+
+	ACCESSORPP_CONSTEXPR14 void doSetValue(const ValueType & newValue, void * /*instance*/) {
+		value = newValue;
+	}
+
+	template <typename F, typename B, typename A>
+	ACCESSORPP_CONSTEXPR14 void doUpdate(F && func, B && beforeWrite, A && afterWrite, void * /*instance*/) {
+		ValueType newValue = func(static_cast<const ValueType &>(value));
+		beforeWrite(static_cast<const ValueType &>(newValue));
+		value = std::move(newValue);
+		afterWrite(static_cast<const ValueType &>(value));
+	}
+
+private:
+	ValueType value;
+};
+
 
 } // namespace private_
 
@@ -18,6 +18,7 @@
 
 #include <utility>
 #include <type_traits>
+#include <functional>
 
 namespace accessorpp {
 
@@ -205,6 +206,48 @@ struct HasTypeClassTypeSetter
 template <typename T, bool, typename Default> struct SelectClassTypeSetter { using Type = typename T::ClassTypeSetter; };
 template <typename T, typename Default> struct SelectClassTypeSetter <T, false, Default> { using Type = Default; };
 
+template <typename T>
+struct HasTypeErrorHandler
+{
+	template <typename C> static std::true_type test(typename C::ErrorHandler *) ;
+	template <typename C> static std::false_type test(...);    
+
+	enum { value = !! decltype(test<T>(0))() };
+};
+template <typename T, bool, typename Default> struct SelectErrorHandler { using Type = typename T::ErrorHandler; };
+template <typename T, typename Default> struct SelectErrorHandler <T, false, Default> { using Type = Default; };
+
+template <typename T>
+struct HasTypeInstrumentation
+{
+	template <typename C> static std::true_type test(typename C::Instrumentation *) ;
+	template <typename C> static std::false_type test(...);    
+
+	enum { value = !! decltype(test<T>(0))() };
+};
+template <typename T, bool, typename Default> struct SelectInstrumentation { using Type = typename T::Instrumentation; };
+template <typename T, typename Default> struct SelectInstrumentation <T, false, Default> { using Type = Default; };
+
+// An empty std::function or a null function pointer. Setter replaces it with a no-op,
+// Getter replaces it with the empty getter, so they never throw std::bad_function_call.
+template <typename F>
+bool isEmptyCallable(const F &)
+{
+	return false;
+}
+
+template <typename RT, typename ...Args>
+bool isEmptyCallable(const std::function<RT (Args...)> & func)
+{
+	return ! func;
+}
+
+template <typename T>
+bool isEmptyCallable(T * func)
+{
+	return func == nullptr;
+}
+
 
 } // namespace private_
 
@@ -0,0 +1,286 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_PARALLELCALLBACKLIST_H_402918375561
+#define ACCESSORPP_PARALLELCALLBACKLIST_H_402918375561
+
+#include "accessorpp/compiler.h"
+#include "accessorpp/error.h"
+#include "accessorpp/threadpool.h"
+
+#include <functional>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+namespace accessorpp {
+
+enum class ParallelDispatch
+{
+	// The invocation returns after all listeners are finished.
+	wait,
+	// The invocation returns immediately, the arguments are copied.
+	async
+};
+
+template <typename Prototype, typename ExceptionPolicy = DefaultExceptionPolicy>
+class ParallelCallbackList;
+
+// ParallelCallbackList is a callback list used as the OnChangingCallback or OnChangedCallback policy.
+// Small lists are dispatched sequentially in the calling thread. Once the number of listeners
+// reaches the parallel threshold, the listeners are split into chunks which are
+// dispatched on the work-stealing ThreadPool.
+// Appending listeners must not happen at the same time as dispatching.
+// With CaptureExceptions, the exceptions thrown by the listeners are rethrown in the calling thread,
+// with NoExceptions, the listeners must not throw.
+template <typename RT, typename ...Args, typename ExceptionPolicy>
+class ParallelCallbackList <RT (Args...), ExceptionPolicy>
+{
+public:
+	using Callback = std::function<RT (Args...)>;
+
+	enum {
+		defaultParallelThreshold = 256
+	};
+
+private:
+	using CallbackList = std::vector<Callback>;
+
+	struct AsyncState
+	{
+		AsyncState() : pendingCount(0), mutex(), idle(), firstException() {
+		}
+
+		std::atomic<std::size_t> pendingCount;
+		std::mutex mutex;
+		std::condition_variable idle;
+		private_::FirstException<ExceptionPolicy> firstException;
+	};
+
+	// Finish one asynchronous task even if a listener throws.
+	struct AsyncTaskGuard
+	{
+		explicit AsyncTaskGuard(AsyncState & state) : state(state) {
+		}
+
+		~AsyncTaskGuard() {
+			if(state.pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				std::lock_guard<std::mutex> lock(state.mutex);
+				state.idle.notify_all();
+			}
+		}
+
+		AsyncState & state;
+	};
+
+	// Shared by the calling thread and the tasks of one dispatchAndWait. The chunks are
+	// claimed by index, so a task which runs after the dispatching returned finds no chunk
+	// left and touches nothing but this state.
+	struct WaitState
+	{
+		explicit WaitState(const std::size_t chunkCount)
+			:
+				chunkCount(chunkCount),
+				nextChunk(0),
+				finishedCount(0),
+				firstException()
+		{
+		}
+
+		const std::size_t chunkCount;
+		std::atomic<std::size_t> nextChunk;
+		std::atomic<std::size_t> finishedCount;
+		private_::FirstException<ExceptionPolicy> firstException;
+	};
+
+public:
+	ParallelCallbackList()
+		:
+			callbackList(std::make_shared<CallbackList>()),
+			threadPool(nullptr),
+			parallelThreshold(defaultParallelThreshold),
+			chunkSize(0),
+			dispatch(ParallelDispatch::wait),
+			asyncState(std::make_shared<AsyncState>())
+	{
+	}
+
+	ParallelCallbackList(const ParallelCallbackList &) = delete;
+	ParallelCallbackList & operator = (const ParallelCallbackList &) = delete;
+
+	// The exception of the pending dispatching, if any, is discarded.
+	~ParallelCallbackList() {
+		waitForPending();
+	}
+
+	void append(const Callback & callback) {
+		// Copy on write, the list may be still used by asynchronous dispatching.
+		if(callbackList.use_count() > 1) {
+			callbackList = std::make_shared<CallbackList>(*callbackList);
+		}
+		callbackList->push_back(callback);
+	}
+
+	std::size_t size() const {
+		return callbackList->size();
+	}
+
+	bool empty() const {
+		return callbackList->empty();
+	}
+
+	// Without thread pool, all listeners are dispatched sequentially.
+	void setThreadPool(ThreadPool * newThreadPool) {
+		threadPool = newThreadPool;
+	}
+
+	// Lists smaller than the threshold are dispatched sequentially in the calling thread.
+	void setParallelThreshold(const std::size_t newParallelThreshold) {
+		parallelThreshold = newParallelThreshold;
+	}
+
+	// 0 means the chunk size is calculated from the number of threads.
+	void setChunkSize(const std::size_t newChunkSize) {
+		chunkSize = newChunkSize;
+	}
+
+	void setDispatch(const ParallelDispatch newDispatch) {
+		dispatch = newDispatch;
+	}
+
+	// Wait until all asynchronous dispatching is finished. If any listener threw,
+	// the first exception since the last waitForIdle is rethrown.
+	void waitForIdle() {
+		waitForPending();
+		asyncState->firstException.rethrow();
+	}
+
+	void operator () (Args ...args) {
+		const std::size_t count = callbackList->size();
+		if(threadPool == nullptr || count < parallelThreshold || count == 0) {
+			for(auto & callback : *callbackList) {
+				callback(args...);
+			}
+			return;
+		}
+
+		const std::size_t size = getChunkSize(count);
+		if(dispatch == ParallelDispatch::async) {
+			dispatchAsync(size, args...);
+		}
+		else {
+			dispatchAndWait(size, args...);
+		}
+	}
+
+private:
+	std::size_t getChunkSize(const std::size_t count) const {
+		if(chunkSize > 0) {
+			return chunkSize;
+		}
+		const std::size_t size = count / (threadPool->getThreadCount() * 4);
+		return size < 16 ? 16 : size;
+	}
+
+	// If any listener throws, the first exception is rethrown in the calling thread
+	// after all chunks are finished.
+	void dispatchAndWait(const std::size_t size, Args ...args) {
+		const std::size_t count = callbackList->size();
+		const std::shared_ptr<WaitState> state = std::make_shared<WaitState>((count + size - 1) / size);
+		CallbackList & callbacks = *callbackList;
+		const auto invokeChunk = [&callbacks, &args...](const std::size_t begin, const std::size_t end) {
+			for(std::size_t i = begin; i < end; ++i) {
+				callbacks[i](args...);
+			}
+		};
+		// The tasks only dereference the pointer after claiming a chunk, which can't
+		// happen after the dispatching returned.
+		const auto invoker = &invokeChunk;
+
+		for(std::size_t i = 1; i < state->chunkCount; ++i) {
+			threadPool->post([state, invoker, size, count]() {
+				runChunks(*state, size, count, invoker);
+			});
+		}
+
+		// The calling thread runs the chunks which are not taken by the pool yet,
+		// it doesn't run the unrelated tasks of the pool.
+		runChunks(*state, size, count, invoker);
+		while(state->finishedCount.load(std::memory_order_acquire) < state->chunkCount) {
+			std::this_thread::yield();
+		}
+		state->firstException.rethrow();
+	}
+
+	void waitForPending() {
+		std::unique_lock<std::mutex> lock(asyncState->mutex);
+		asyncState->idle.wait(lock, [this]() {
+			return asyncState->pendingCount.load(std::memory_order_acquire) == 0;
+		});
+	}
+
+	template <typename F>
+	static void runChunks(WaitState & state, const std::size_t size, const std::size_t count, const F * invoker) {
+		for(;;) {
+			const std::size_t chunk = state.nextChunk.fetch_add(1, std::memory_order_relaxed);
+			if(chunk >= state.chunkCount) {
+				return;
+			}
+			const std::size_t begin = chunk * size;
+			const std::size_t end = (begin + size < count ? begin + size : count);
+			// The exception is captured, so finishedCount is always increased
+			// and the exception doesn't escape from the thread pool.
+			state.firstException.invoke([invoker, begin, end]() {
+				(*invoker)(begin, end);
+			});
+			state.finishedCount.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	template <typename ...A>
+	void dispatchAsync(const std::size_t size, const A & ...args) {
+		const std::size_t count = callbackList->size();
+		std::shared_ptr<CallbackList> callbacks = callbackList;
+		std::shared_ptr<AsyncState> state = asyncState;
+		state->pendingCount.fetch_add((count + size - 1) / size, std::memory_order_relaxed);
+
+		for(std::size_t begin = 0; begin < count; begin += size) {
+			const std::size_t end = (begin + size < count ? begin + size : count);
+			threadPool->post([callbacks, state, begin, end, args...]() {
+				AsyncTaskGuard guard(*state);
+				state->firstException.invoke([&callbacks, begin, end, &args...]() {
+					for(std::size_t i = begin; i < end; ++i) {
+						(*callbacks)[i](args...);
+					}
+				});
+			});
+		}
+	}
+
+private:
+	std::shared_ptr<CallbackList> callbackList;
+	ThreadPool * threadPool;
+	std::size_t parallelThreshold;
+	std::size_t chunkSize;
+	ParallelDispatch dispatch;
+	std::shared_ptr<AsyncState> asyncState;
+};
+
+
+} // namespace accessorpp
+
+#endif
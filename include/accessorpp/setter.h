@@ -18,7 +18,7 @@
 
 #include <functional>
 #include <type_traits>
-#include <istream> 
+#include <iosfwd>
 
 namespace accessorpp {
 
@@ -29,9 +29,12 @@ public:
 	using Type = Type_;
 	using ValueType = typename private_::GetUnderlyingType<Type>::Type;
 
+private:
+	using SetterFunc = std::function<void (void *, const ValueType &)>;
+
 public:
 	Setter()
-		: setterFunc([](void *, const ValueType &) {})
+		: setterFunc(makeNoOp())
 	{
 	}
 
@@ -59,7 +62,10 @@ public:
 	template <typename F>
 	explicit Setter(F func,
 		typename std::enable_if<private_::CanInvoke<F, ValueType>::value>::type * = nullptr)
-		: setterFunc([func](void *, const ValueType & value) { func(value); })
+		: setterFunc(private_::isEmptyCallable(func)
+			? makeNoOp()
+			: SetterFunc([func](void *, const ValueType & value) { func(value); })
+		)
 	{
 	}
 
@@ -84,9 +90,11 @@ public:
 	{
 	}
 
+	// The moved from setter is a no-op, it never holds an empty function.
 	Setter(Setter && other)
 		: setterFunc(std::move(other.setterFunc))
 	{
+		other.setterFunc = makeNoOp();
 	}
 
 	Setter & operator = (const Setter & other) {
@@ -95,7 +103,10 @@ public:
 	}
 
 	Setter & operator = (Setter && other) {
-		setterFunc = std::move(other.setterFunc);
+		if(this != &other) {
+			setterFunc = std::move(other.setterFunc);
+			other.setterFunc = makeNoOp();
+		}
 		return *this;
 	}
 
@@ -109,7 +120,12 @@ public:
 	}
 
 private:
-	std::function<void (void *, const ValueType &)> setterFunc;
+	static SetterFunc makeNoOp() {
+		return [](void *, const ValueType &) {};
+	}
+
+private:
+	SetterFunc setterFunc;
 };
 
 template <typename T>
@@ -0,0 +1,259 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_THREADCACHED_H_580271936402
+#define ACCESSORPP_THREADCACHED_H_580271936402
+
+#include "accessorpp/accessorcore.h"
+
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace accessorpp {
+
+// The getter and setter are provided by the user, same as ExternalStorage.
+// Each thread caches the value returned by the getter, and calls the getter again
+// only when the thread cache generation changes, or when the staleness bound expires.
+struct ThreadCachedStorage {};
+
+namespace private_ {
+
+inline std::atomic<std::uint64_t> & getThreadCacheGeneration()
+{
+	static std::atomic<std::uint64_t> generation(1);
+	return generation;
+}
+
+inline std::uint64_t allocateThreadCacheOwnerId()
+{
+	static std::atomic<std::uint64_t> ownerId(0);
+	return ownerId.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// The slot indexes are allocated per value type, so the thread local cache
+// of each type is a plain array indexed by the slot.
+template <typename T>
+class ThreadCacheSlots
+{
+public:
+	struct Slot
+	{
+		Slot() : ownerId(0), generation(0), expireTime(), value() {
+		}
+
+		std::uint64_t ownerId;
+		std::uint64_t generation;
+		std::chrono::steady_clock::time_point expireTime;
+		T value;
+	};
+
+public:
+	static std::size_t allocate() {
+		ThreadCacheSlots & slots = getInstance();
+		std::lock_guard<std::mutex> lock(slots.mutex);
+		if(! slots.freeList.empty()) {
+			const std::size_t index = slots.freeList.back();
+			slots.freeList.pop_back();
+			return index;
+		}
+		return slots.nextIndex++;
+	}
+
+	static void free(const std::size_t index) {
+		ThreadCacheSlots & slots = getInstance();
+		std::lock_guard<std::mutex> lock(slots.mutex);
+		slots.freeList.push_back(index);
+	}
+
+	static std::vector<Slot> & getThreadSlotList() {
+		static thread_local std::vector<Slot> slotList;
+		return slotList;
+	}
+
+private:
+	ThreadCacheSlots() : mutex(), freeList(), nextIndex(0) {
+	}
+
+	static ThreadCacheSlots & getInstance() {
+		static ThreadCacheSlots slots;
+		return slots;
+	}
+
+private:
+	std::mutex mutex;
+	std::vector<std::size_t> freeList;
+	std::size_t nextIndex;
+};
+
+template <typename Type_, typename PoliciesType>
+class AccessorBase <Type_, ThreadCachedStorage, PoliciesType> : public AccessorRoot<Type_, PoliciesType>
+{
+private:
+	using super = AccessorRoot<Type_, PoliciesType>;
+	using ValueType = typename std::remove_cv<typename std::remove_reference<Type_>::type>::type;
+	using SlotsType = ThreadCacheSlots<ValueType>;
+
+	static_assert(! std::is_reference<Type_>::value, "ThreadCachedStorage can't return reference.");
+
+public:
+	using GetterType = typename super::GetterType;
+	using SetterType = typename super::SetterType;
+	using Duration = std::chrono::steady_clock::duration;
+
+public:
+	template <typename G, typename S>
+	AccessorBase(G && getter, S && setter)
+		:
+			super(makeGetter(), makeSetter()),
+			sourceGetter(std::forward<G>(getter)),
+			sourceSetter(std::forward<S>(setter)),
+			slotIndex(SlotsType::allocate()),
+			ownerId(allocateThreadCacheOwnerId()),
+			staleness(Duration::zero())
+	{
+	}
+
+	template <typename G>
+	AccessorBase(G && getter, NoSetter)
+		:
+			super(makeGetter(), noSetter),
+			sourceGetter(std::forward<G>(getter)),
+			sourceSetter(),
+			slotIndex(SlotsType::allocate()),
+			ownerId(allocateThreadCacheOwnerId()),
+			staleness(Duration::zero())
+	{
+	}
+
+	// The copy is read-only if other is read-only.
+	AccessorBase(const AccessorBase & other)
+		:
+			super(other.isReadOnly() ? super(makeGetter(), noSetter) : super(makeGetter(), makeSetter())),
+			sourceGetter(other.sourceGetter),
+			sourceSetter(other.sourceSetter),
+			slotIndex(SlotsType::allocate()),
+			ownerId(allocateThreadCacheOwnerId()),
+			staleness(other.staleness)
+	{
+	}
+
+	~AccessorBase() {
+		SlotsType::free(slotIndex);
+	}
+
+	// Zero means the cached value never expires, it's only refreshed by invalidateThreadCaches.
+	// Must be set before the accessor is used by other threads.
+	void setStaleness(const Duration newStaleness) {
+		staleness = newStaleness;
+	}
+
+	Duration getStaleness() const {
+		return staleness;
+	}
+
+	// Read the value from the cache of the calling thread. Accessor::get() calls this
+	// through the getter, calling getCached() directly avoids the std::function call.
+	ValueType getCached() const {
+		const std::vector<typename SlotsType::Slot> & slotList = SlotsType::getThreadSlotList();
+		if(slotIndex < slotList.size()) {
+			const typename SlotsType::Slot & slot = slotList[slotIndex];
+			if(slot.ownerId == ownerId
+				&& slot.generation == getThreadCacheGeneration().load(std::memory_order_acquire)
+				&& (staleness == Duration::zero() || std::chrono::steady_clock::now() < slot.expireTime)
+			) {
+				return slot.value;
+			}
+		}
+		return refresh();
+	}
+
+	const GetterType & getSourceGetter() const {
+		return sourceGetter;
+	}
+
+	const SetterType & getSourceSetter() const {
+		return sourceSetter;
+	}
+
+protected:
+	// Bypass the cache, the cached value may be stale.
+	template <typename F, typename B, typename A>
+	void doUpdate(F && func, B && beforeWrite, A && afterWrite, void * instance) {
+		const ValueType newValue = func(static_cast<const ValueType &>(sourceGetter.get(instance)));
+		beforeWrite(newValue);
+		this->setter.set(newValue, instance);
+		afterWrite(newValue);
+	}
+
+private:
+	ValueType refresh() const {
+		// Read the generation before calling the getter, so a change during the call
+		// causes another refresh.
+		const std::uint64_t generation = getThreadCacheGeneration().load(std::memory_order_acquire);
+		// The getter may read another cached accessor of the same type, which resizes
+		// the slot list, so the slot is looked up only after the getter returns.
+		ValueType value = sourceGetter.get();
+		std::vector<typename SlotsType::Slot> & slotList = SlotsType::getThreadSlotList();
+		if(slotIndex >= slotList.size()) {
+			slotList.resize(slotIndex + 1);
+		}
+		typename SlotsType::Slot & slot = slotList[slotIndex];
+		slot.value = std::move(value);
+		slot.ownerId = ownerId;
+		slot.generation = generation;
+		if(staleness != Duration::zero()) {
+			slot.expireTime = std::chrono::steady_clock::now() + staleness;
+		}
+		return slot.value;
+	}
+
+	GetterType makeGetter() {
+		return GetterType([this]() -> ValueType {
+			return this->getCached();
+		});
+	}
+
+	SetterType makeSetter() {
+		return SetterType([this](const ValueType & newValue) {
+			this->sourceSetter.set(newValue);
+			getThreadCacheGeneration().fetch_add(1, std::memory_order_acq_rel);
+		});
+	}
+
+private:
+	GetterType sourceGetter;
+	SetterType sourceSetter;
+	const std::size_t slotIndex;
+	const std::uint64_t ownerId;
+	Duration staleness;
+};
+
+} // namespace private_
+
+// Invalidate the cached values of all accessors using ThreadCachedStorage in all threads.
+// Call it after changing the underlying data without setting via the accessors.
+inline void invalidateThreadCaches()
+{
+	private_::getThreadCacheGeneration().fetch_add(1, std::memory_order_acq_rel);
+}
+
+
+} // namespace accessorpp
+
+#endif
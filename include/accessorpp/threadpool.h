@@ -0,0 +1,215 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_THREADPOOL_H_618350927461
+#define ACCESSORPP_THREADPOOL_H_618350927461
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace accessorpp {
+
+// A fixed size work-stealing thread pool. It can be used as the executor of ExecutorCallback,
+// and it's used by ParallelCallbackList.
+// Each worker thread has its own task queue. A task posted from a worker thread goes to
+// the worker's own queue, other tasks are distributed round-robin.
+// An idle worker steals tasks from the other workers.
+class ThreadPool
+{
+public:
+	using Task = std::function<void ()>;
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Task> taskQueue;
+	};
+
+public:
+	explicit ThreadPool(std::size_t threadCount = 0)
+		:
+			workerList(),
+			threadList(),
+			pendingCount(0),
+			nextWorker(0),
+			sleepMutex(),
+			taskAvailable(),
+			stopping(false)
+	{
+		if(threadCount == 0) {
+			threadCount = std::thread::hardware_concurrency();
+			if(threadCount == 0) {
+				threadCount = 1;
+			}
+		}
+		for(std::size_t i = 0; i < threadCount; ++i) {
+			workerList.emplace_back(new Worker());
+		}
+		for(std::size_t i = 0; i < threadCount; ++i) {
+			threadList.emplace_back([this, i]() {
+				this->doWork(i);
+			});
+		}
+	}
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool & operator = (const ThreadPool &) = delete;
+
+	// All posted tasks are finished before the destructor returns.
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			stopping = true;
+		}
+		taskAvailable.notify_all();
+		for(auto & thread : threadList) {
+			thread.join();
+		}
+	}
+
+	std::size_t getThreadCount() const {
+		return threadList.size();
+	}
+
+	void post(Task task) {
+		std::size_t index;
+		if(getCurrentPool() == this) {
+			index = getCurrentWorkerIndex();
+		}
+		else {
+			index = nextWorker.fetch_add(1, std::memory_order_relaxed) % workerList.size();
+		}
+		{
+			// The count is changed under the same lock as the queue, so a worker which
+			// sees a pending task always finds it, and the count never goes below zero.
+			Worker & worker = *workerList[index];
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			worker.taskQueue.push_back(std::move(task));
+			pendingCount.fetch_add(1, std::memory_order_release);
+		}
+		{
+			// Lock and unlock to avoid lost wake up.
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		taskAvailable.notify_one();
+	}
+
+	// Run one pending task in the calling thread, return false if there is no task.
+	// A thread waiting for tasks in the pool can call this to help instead of blocking.
+	// A thread which is not a worker of this pool only steals the oldest tasks.
+	bool tryRunTask() {
+		Task task;
+		const bool found = (getCurrentPool() == this
+			? takeTask(getCurrentWorkerIndex(), task)
+			: stealTask(nextWorker.load(std::memory_order_relaxed), 0, task)
+		);
+		if(! found) {
+			return false;
+		}
+		task();
+		return true;
+	}
+
+private:
+	void doWork(const std::size_t index) {
+		getCurrentPool() = this;
+		getCurrentWorkerIndex() = index;
+
+		for(;;) {
+			Task task;
+			if(takeTask(index, task)) {
+				task();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			taskAvailable.wait(lock, [this]() {
+				return stopping || pendingCount.load(std::memory_order_acquire) > 0;
+			});
+			if(stopping && pendingCount.load(std::memory_order_acquire) == 0) {
+				return;
+			}
+		}
+	}
+
+	bool takeTask(const std::size_t index, Task & task) {
+		if(pendingCount.load(std::memory_order_acquire) == 0) {
+			return false;
+		}
+
+		// Own queue is LIFO for cache locality, stealing is FIFO.
+		{
+			Worker & worker = *workerList[index];
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			if(! worker.taskQueue.empty()) {
+				task = std::move(worker.taskQueue.back());
+				worker.taskQueue.pop_back();
+				pendingCount.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return stealTask(index, 1, task);
+	}
+
+	// Take the oldest task from the workers starting at index + first.
+	bool stealTask(const std::size_t index, const std::size_t first, Task & task) {
+		if(pendingCount.load(std::memory_order_acquire) == 0) {
+			return false;
+		}
+
+		const std::size_t count = workerList.size();
+		for(std::size_t i = first; i < count; ++i) {
+			Worker & victim = *workerList[(index + i) % count];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if(! victim.taskQueue.empty()) {
+				task = std::move(victim.taskQueue.front());
+				victim.taskQueue.pop_front();
+				pendingCount.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static ThreadPool *& getCurrentPool() {
+		static thread_local ThreadPool * pool = nullptr;
+		return pool;
+	}
+
+	static std::size_t & getCurrentWorkerIndex() {
+		static thread_local std::size_t index = 0;
+		return index;
+	}
+
+private:
+	std::vector<std::unique_ptr<Worker> > workerList;
+	std::vector<std::thread> threadList;
+	std::atomic<std::size_t> pendingCount;
+	std::atomic<std::size_t> nextWorker;
+	std::mutex sleepMutex;
+	std::condition_variable taskAvailable;
+	bool stopping;
+};
+
+
+} // namespace accessorpp
+
+#endif
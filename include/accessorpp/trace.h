@@ -0,0 +1,493 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_TRACE_H_482917305641
+#define ACCESSORPP_TRACE_H_482917305641
+
+#include "accessorpp/accessorcore.h"
+
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+#include <ostream>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace accessorpp {
+
+class Tracer;
+
+namespace private_ {
+
+enum class TraceCategory : unsigned char
+{
+	set,
+	callback
+};
+
+struct TraceEvent
+{
+	const char * name;
+	// Nanoseconds since the tracer is created.
+	std::uint64_t timestamp;
+	// Only the end events of the callbacks which exceed the budget have the duration, others are 0.
+	std::uint64_t overBudgetDuration;
+	char phase;
+	TraceCategory category;
+};
+
+// The events of one thread. Only the owner thread pushes events, and the events
+// are published by the release store of size, so Tracer can read them without locking.
+// If the buffer is full, the new events are dropped.
+// Tracer::clear doesn't touch the events, it bumps the clear generation. The owner thread
+// empties the buffer before its next event, and Tracer skips the buffers of the old generations.
+class TraceBuffer
+{
+public:
+	TraceBuffer(const std::size_t bufferCapacity, const int id, const std::uint64_t generation, const std::uint64_t enabledGeneration)
+		:
+			eventList(new TraceEvent[bufferCapacity]),
+			capacity(bufferCapacity),
+			size(0),
+			droppedCount(0),
+			clearGeneration(generation),
+			enabledGeneration(enabledGeneration),
+			threadId(id),
+			exited(false),
+			beginTimeStack()
+	{
+	}
+
+	// Called by the owner thread before it records an event.
+	void synchronize(const std::uint64_t currentClearGeneration, const std::uint64_t currentEnabledGeneration) {
+		if(enabledGeneration != currentEnabledGeneration) {
+			// The ends of the sets and callbacks which began before the tracing was toggled may be missing.
+			enabledGeneration = currentEnabledGeneration;
+			beginTimeStack.clear();
+		}
+		if(clearGeneration.load(std::memory_order_relaxed) != currentClearGeneration) {
+			size.store(0, std::memory_order_relaxed);
+			droppedCount.store(0, std::memory_order_relaxed);
+			beginTimeStack.clear();
+			clearGeneration.store(currentClearGeneration, std::memory_order_release);
+		}
+	}
+
+	void push(const TraceEvent & event) {
+		const std::size_t index = size.load(std::memory_order_relaxed);
+		if(index >= capacity) {
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		eventList[index] = event;
+		size.store(index + 1, std::memory_order_release);
+	}
+
+private:
+	std::unique_ptr<TraceEvent[]> eventList;
+	std::size_t capacity;
+	std::atomic<std::size_t> size;
+	std::atomic<std::uint64_t> droppedCount;
+	std::atomic<std::uint64_t> clearGeneration;
+	// Used by the owner thread only.
+	std::uint64_t enabledGeneration;
+	int threadId;
+	// Guarded by the mutex of Tracer.
+	bool exited;
+	// The begin time of the unfinished sets and callbacks, used by the owner thread only.
+	std::vector<std::uint64_t> beginTimeStack;
+
+	friend class accessorpp::Tracer;
+};
+
+// Function static variables are guarded, a static member of a class template is not.
+template <typename Dummy>
+struct TracerEnabledFlag
+{
+	static std::atomic<bool> enabled;
+	// Bumped each time the tracing is toggled.
+	static std::atomic<std::uint64_t> generation;
+};
+
+template <typename Dummy>
+std::atomic<bool> TracerEnabledFlag<Dummy>::enabled(false);
+
+template <typename Dummy>
+std::atomic<std::uint64_t> TracerEnabledFlag<Dummy>::generation(0);
+
+} // namespace private_
+
+// Tracer records the begin and end of the sets and callbacks of the accessors using TraceAccesses,
+// to a buffer per thread, and writes them as a Chrome trace (chrome://tracing, Perfetto).
+// The tracing is disabled by default, then each hook costs one predictable branch.
+class Tracer
+{
+public:
+	static Tracer & getInstance() {
+		static Tracer tracer;
+		return tracer;
+	}
+
+	static bool isEnabled() {
+		return private_::TracerEnabledFlag<void>::enabled.load(std::memory_order_relaxed);
+	}
+
+	// If the tracing is changed while a set or callback is running, its end event may be missing.
+	// The unfinished begins are discarded, so they are never matched with the ends after toggling.
+	static void setEnabled(const bool enabled) {
+		private_::TracerEnabledFlag<void>::generation.fetch_add(1, std::memory_order_relaxed);
+		private_::TracerEnabledFlag<void>::enabled.store(enabled, std::memory_order_release);
+	}
+
+	// The callbacks which take longer than the budget are flagged in the trace. 0 disables the budget.
+	void setCallbackBudget(const std::chrono::nanoseconds budget) {
+		callbackBudget.store((std::uint64_t)budget.count(), std::memory_order_relaxed);
+	}
+
+	std::chrono::nanoseconds getCallbackBudget() const {
+		return std::chrono::nanoseconds((std::chrono::nanoseconds::rep)callbackBudget.load(std::memory_order_relaxed));
+	}
+
+	// The maximum event count of each thread. It applies to the threads which record their first event later.
+	void setBufferCapacity(const std::size_t capacity) {
+		bufferCapacity.store(capacity, std::memory_order_relaxed);
+	}
+
+	std::size_t getBufferCapacity() const {
+		return bufferCapacity.load(std::memory_order_relaxed);
+	}
+
+	std::size_t getEventCount() const {
+		std::size_t result = 0;
+		std::lock_guard<std::mutex> lock(mutex);
+		for(const std::unique_ptr<private_::TraceBuffer> & buffer : bufferList) {
+			if(isCurrent(*buffer)) {
+				result += buffer->size.load(std::memory_order_acquire);
+			}
+		}
+		return result;
+	}
+
+	// The events dropped because the buffer of the thread is full.
+	std::uint64_t getDroppedCount() const {
+		std::uint64_t result = 0;
+		std::lock_guard<std::mutex> lock(mutex);
+		for(const std::unique_ptr<private_::TraceBuffer> & buffer : bufferList) {
+			if(isCurrent(*buffer)) {
+				result += buffer->droppedCount.load(std::memory_order_relaxed);
+			}
+		}
+		return result;
+	}
+
+	// The number of the thread buffers, including the exited threads whose events are not cleared yet.
+	std::size_t getBufferCount() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return bufferList.size();
+	}
+
+	std::uint64_t getOverBudgetCount() const {
+		return overBudgetCount.load(std::memory_order_relaxed);
+	}
+
+	// Discard the recorded events, and free the buffers of the exited threads.
+	// It can be called while other threads are recording, each thread empties
+	// its own buffer before its next event.
+	void clear() {
+		std::lock_guard<std::mutex> lock(mutex);
+		clearGeneration.fetch_add(1, std::memory_order_release);
+		bufferList.erase(
+			std::remove_if(
+				bufferList.begin(),
+				bufferList.end(),
+				[](const std::unique_ptr<private_::TraceBuffer> & buffer) { return buffer->exited; }
+			),
+			bufferList.end()
+		);
+		overBudgetCount.store(0, std::memory_order_relaxed);
+	}
+
+	// Write the events in Chrome trace event format. It can be called while the tracing is running,
+	// the events recorded after it starts may be missing.
+	void writeChromeTrace(std::ostream & stream) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		stream << "{\"traceEvents\":[";
+		bool first = true;
+		for(const std::unique_ptr<private_::TraceBuffer> & buffer : bufferList) {
+			if(! isCurrent(*buffer)) {
+				continue;
+			}
+			const std::size_t size = buffer->size.load(std::memory_order_acquire);
+			for(std::size_t i = 0; i < size; ++i) {
+				doWriteEvent(stream, buffer->eventList[i], buffer->threadId, first);
+			}
+		}
+		stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+	}
+
+	bool saveChromeTrace(const std::string & fileName) const {
+		std::ofstream stream(fileName.c_str(), std::ios::binary);
+		if(! stream) {
+			return false;
+		}
+		writeChromeTrace(stream);
+		return (bool)stream;
+	}
+
+private:
+	// Returns the buffer to the tracer when the thread exits.
+	struct ThreadBufferHolder
+	{
+		ThreadBufferHolder() : buffer(nullptr) {
+		}
+
+		~ThreadBufferHolder() {
+			if(buffer != nullptr) {
+				Tracer::getInstance().releaseThreadBuffer(buffer);
+			}
+		}
+
+		private_::TraceBuffer * buffer;
+	};
+
+private:
+	Tracer()
+		:
+			mutex(),
+			bufferList(),
+			nextThreadId(1),
+			clearGeneration(0),
+			nameSet(),
+			startTime(std::chrono::steady_clock::now()),
+			callbackBudget(0),
+			bufferCapacity(1024 * 64),
+			overBudgetCount(0)
+	{
+	}
+
+	Tracer(const Tracer &) = delete;
+	Tracer & operator = (const Tracer &) = delete;
+
+	// The names are never freed, so the events can refer to the names of the destroyed accessors.
+	const char * internName(const std::string & name) {
+		std::lock_guard<std::mutex> lock(mutex);
+		return nameSet.insert(name).first->c_str();
+	}
+
+	void doBegin(const char * name, const private_::TraceCategory category) {
+		private_::TraceBuffer & buffer = getThreadBuffer();
+		const std::uint64_t timestamp = getTimestamp();
+		buffer.beginTimeStack.push_back(timestamp);
+		buffer.push({ name, timestamp, 0, 'B', category });
+	}
+
+	void doEnd(const char * name, const private_::TraceCategory category) {
+		private_::TraceBuffer & buffer = getThreadBuffer();
+		// The begin was not recorded because the tracing was enabled in between.
+		if(buffer.beginTimeStack.empty()) {
+			return;
+		}
+		const std::uint64_t timestamp = getTimestamp();
+		const std::uint64_t duration = timestamp - buffer.beginTimeStack.back();
+		buffer.beginTimeStack.pop_back();
+
+		std::uint64_t overBudgetDuration = 0;
+		const std::uint64_t budget = callbackBudget.load(std::memory_order_relaxed);
+		if(category == private_::TraceCategory::callback && budget > 0 && duration > budget) {
+			overBudgetDuration = duration;
+			overBudgetCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		buffer.push({ name, timestamp, overBudgetDuration, 'E', category });
+	}
+
+	std::uint64_t getTimestamp() const {
+		return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - startTime
+		).count();
+	}
+
+	// The buffers are owned by the tracer, so the events of the exited threads are kept until clear().
+	private_::TraceBuffer & getThreadBuffer() {
+		thread_local ThreadBufferHolder holder;
+		const std::uint64_t currentClearGeneration = clearGeneration.load(std::memory_order_acquire);
+		const std::uint64_t currentEnabledGeneration = private_::TracerEnabledFlag<void>::generation.load(std::memory_order_relaxed);
+		if(holder.buffer == nullptr) {
+			std::lock_guard<std::mutex> lock(mutex);
+			bufferList.emplace_back(new private_::TraceBuffer(
+				getBufferCapacity(), nextThreadId++, currentClearGeneration, currentEnabledGeneration
+			));
+			holder.buffer = bufferList.back().get();
+		}
+		holder.buffer->synchronize(currentClearGeneration, currentEnabledGeneration);
+		return *holder.buffer;
+	}
+
+	// The buffer without events is freed now, others are freed by the next clear().
+	void releaseThreadBuffer(private_::TraceBuffer * buffer) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for(auto it = bufferList.begin(); it != bufferList.end(); ++it) {
+			if(it->get() == buffer) {
+				if(! isCurrent(*buffer)
+					|| (buffer->size.load(std::memory_order_relaxed) == 0 && buffer->droppedCount.load(std::memory_order_relaxed) == 0)) {
+					bufferList.erase(it);
+				}
+				else {
+					buffer->exited = true;
+				}
+				return;
+			}
+		}
+	}
+
+	// The events in a buffer of an old clear generation are discarded, the owner thread
+	// empties it before its next event.
+	// Must be called with the mutex locked, so the generation doesn't change.
+	bool isCurrent(const private_::TraceBuffer & buffer) const {
+		return buffer.clearGeneration.load(std::memory_order_acquire) == clearGeneration.load(std::memory_order_relaxed);
+	}
+
+	static void doWriteEvent(
+			std::ostream & stream,
+			const private_::TraceEvent & event,
+			const int threadId,
+			bool & first
+		) {
+		const char * category = (event.category == private_::TraceCategory::set ? "set" : "callback");
+		const auto writeCommon = [&stream, &event, threadId, &first](const char * phase, const char * prefix) {
+			stream << (first ? "\n" : ",\n");
+			first = false;
+			stream << "{\"name\":";
+			writeJsonString(stream, prefix, event.name);
+			stream << ",\"ph\":\"" << phase << "\",\"ts\":";
+			writeMicroseconds(stream, event.timestamp);
+			stream << ",\"pid\":1,\"tid\":" << threadId;
+		};
+
+		writeCommon(event.phase == 'B' ? "B" : "E", "");
+		stream << ",\"cat\":\"" << category << "\"";
+		if(event.overBudgetDuration > 0) {
+			stream << ",\"args\":{\"overBudget\":true,\"durationUs\":";
+			writeMicroseconds(stream, event.overBudgetDuration);
+			stream << "}}";
+
+			// An instant event makes the slow callback easy to find in the viewer.
+			writeCommon("i", "over budget: ");
+			stream << ",\"cat\":\"budget\",\"s\":\"t\",\"cname\":\"terrible\"}";
+		}
+		else {
+			stream << "}";
+		}
+	}
+
+	static void writeMicroseconds(std::ostream & stream, const std::uint64_t nanoseconds) {
+		char text[32];
+		std::snprintf(text, sizeof(text), "%llu.%03u",
+			(unsigned long long)(nanoseconds / 1000), (unsigned int)(nanoseconds % 1000));
+		stream << text;
+	}
+
+	static void writeJsonString(std::ostream & stream, const char * prefix, const char * text) {
+		stream << '"' << prefix;
+		for(const char * p = (*text == 0 ? "(unnamed)" : text); *p != 0; ++p) {
+			const unsigned char c = (unsigned char)*p;
+			if(c == '"' || c == '\\') {
+				stream << '\\' << (char)c;
+			}
+			else if(c < 0x20) {
+				char escaped[8];
+				std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)c);
+				stream << escaped;
+			}
+			else {
+				stream << (char)c;
+			}
+		}
+		stream << '"';
+	}
+
+private:
+	mutable std::mutex mutex;
+	std::vector<std::unique_ptr<private_::TraceBuffer> > bufferList;
+	int nextThreadId;
+	std::atomic<std::uint64_t> clearGeneration;
+	std::unordered_set<std::string> nameSet;
+	std::chrono::steady_clock::time_point startTime;
+	std::atomic<std::uint64_t> callbackBudget;
+	std::atomic<std::size_t> bufferCapacity;
+	std::atomic<std::uint64_t> overBudgetCount;
+
+	friend class TraceAccesses;
+};
+
+// The Instrumentation policy which records the sets and the callbacks to Tracer.
+// The name of the accessor is the event name in the trace.
+class TraceAccesses
+{
+public:
+	TraceAccesses() : name("") {
+	}
+
+	void setName(const std::string & newName) {
+		name = Tracer::getInstance().internName(newName);
+	}
+
+	std::string getName() const {
+		return name;
+	}
+
+	// The hooks called by Accessor.
+	void onGet() const {
+	}
+
+	void onSetBegin() const {
+		if(Tracer::isEnabled()) {
+			Tracer::getInstance().doBegin(name, private_::TraceCategory::set);
+		}
+	}
+
+	void onSetEnd() const {
+		if(Tracer::isEnabled()) {
+			Tracer::getInstance().doEnd(name, private_::TraceCategory::set);
+		}
+	}
+
+	void onSuppressedSet() const {
+	}
+
+	void onCallbackBegin() const {
+		if(Tracer::isEnabled()) {
+			Tracer::getInstance().doBegin(name, private_::TraceCategory::callback);
+		}
+	}
+
+	void onCallbackEnd() const {
+		if(Tracer::isEnabled()) {
+			Tracer::getInstance().doEnd(name, private_::TraceCategory::callback);
+		}
+	}
+
+private:
+	// Interned by Tracer, it lives as long as the program.
+	const char * name;
+};
+
+} // namespace accessorpp
+
+#endif
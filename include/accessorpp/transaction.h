@@ -0,0 +1,515 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_TRANSACTION_H_739105826473
+#define ACCESSORPP_TRANSACTION_H_739105826473
+
+#include "accessorpp/accessorcore.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+#include <type_traits>
+
+namespace accessorpp {
+
+// The value is stored in a versioned cell. Accessors using TransactionalStorage
+// can be read and written by multiple threads, and several accessors can be
+// updated atomically using transact().
+struct TransactionalStorage {};
+
+namespace private_ {
+
+// Thrown by Transaction::get in transact() when a read conflicts, to abort the
+// transaction body before it works on inconsistent values. transact() catches it.
+struct TransactionConflict {};
+
+// Run the transaction body of transact(). With CaptureExceptions, a conflicting read aborts the body.
+template <typename ExceptionPolicy>
+struct TransactionBody
+{
+#ifdef ACCESSORPP_NO_EXCEPTIONS
+	static_assert(sizeof(ExceptionPolicy *) == 0,
+		"CaptureExceptions can't be used when exceptions are disabled. "
+		"Use transact<NoExceptions>, or define ACCESSORPP_DEFAULT_EXCEPTION_POLICY in every translation unit."
+	);
+#else
+	using AbortFunc = void (*)();
+
+	static AbortFunc getAbort() {
+		return &abort;
+	}
+
+	// Return false if the body is aborted.
+	template <typename F, typename T>
+	static bool run(F & func, T & transaction) {
+		try {
+			func(transaction);
+		}
+		catch(const TransactionConflict &) {
+			return false;
+		}
+		return true;
+	}
+
+private:
+	static void abort() {
+		throw TransactionConflict();
+	}
+#endif
+};
+
+// The body can't be aborted, the conflict is detected in commit.
+template <>
+struct TransactionBody <NoExceptions>
+{
+	using AbortFunc = void (*)();
+
+	static AbortFunc getAbort() {
+		return nullptr;
+	}
+
+	template <typename F, typename T>
+	static bool run(F & func, T & transaction) {
+		func(transaction);
+		return true;
+	}
+};
+
+inline std::atomic<std::uint64_t> & getTransactionClock()
+{
+	static std::atomic<std::uint64_t> clock(0);
+	return clock;
+}
+
+// The lowest bit of versionLock is the lock, the other bits are the version.
+class TransactionalCellBase
+{
+public:
+	TransactionalCellBase()
+		: versionLock(0)
+	{
+	}
+
+	std::uint64_t loadVersionLock() const {
+		return versionLock.load(std::memory_order_acquire);
+	}
+
+	static bool isLocked(const std::uint64_t value) {
+		return (value & 1) != 0;
+	}
+
+	static std::uint64_t getVersion(const std::uint64_t value) {
+		return value >> 1;
+	}
+
+	// Return false if the cell is locked by others.
+	bool tryLock(std::uint64_t & lockedFrom) {
+		std::uint64_t value = versionLock.load(std::memory_order_acquire);
+		for(;;) {
+			if(isLocked(value)) {
+				return false;
+			}
+			if(versionLock.compare_exchange_weak(value, value | 1, std::memory_order_acquire, std::memory_order_acquire)) {
+				lockedFrom = value;
+				return true;
+			}
+		}
+	}
+
+	// Lock only if the versionLock is still expected.
+	bool tryLockIfUnchanged(std::uint64_t expected) {
+		return ! isLocked(expected)
+			&& versionLock.compare_exchange_strong(expected, expected | 1, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	std::uint64_t lock() {
+		std::uint64_t lockedFrom;
+		while(! tryLock(lockedFrom)) {
+			std::this_thread::yield();
+		}
+		return lockedFrom;
+	}
+
+	void unlock(const std::uint64_t newVersion) {
+		versionLock.store(newVersion << 1, std::memory_order_release);
+	}
+
+	void unlockUnchanged(const std::uint64_t lockedFrom) {
+		versionLock.store(lockedFrom, std::memory_order_release);
+	}
+
+private:
+	std::atomic<std::uint64_t> versionLock;
+};
+
+template <typename T>
+class TransactionalCell : public TransactionalCellBase
+{
+public:
+	using ValuePtr = std::shared_ptr<const T>;
+
+public:
+	explicit TransactionalCell(const T & newValue)
+		: TransactionalCellBase(), value(std::make_shared<const T>(newValue))
+	{
+	}
+
+	ValuePtr loadPtr() const {
+		return std::atomic_load_explicit(&value, std::memory_order_acquire);
+	}
+
+	T load() const {
+		return *loadPtr();
+	}
+
+	// Must be called with the cell locked.
+	void publish(const ValuePtr & newValue) {
+		std::atomic_store_explicit(&value, newValue, std::memory_order_release);
+	}
+
+	// Write out of any transaction.
+	void store(const T & newValue) {
+		ValuePtr newValuePtr = std::make_shared<const T>(newValue);
+		lock();
+		const std::uint64_t newVersion = getTransactionClock().fetch_add(1, std::memory_order_acq_rel) + 1;
+		publish(newValuePtr);
+		unlock(newVersion);
+	}
+
+	// Optimistic read-modify-write out of any transaction. func and beforeWrite are
+	// invoked again if the cell is changed by others before it's locked.
+	template <typename F, typename B>
+	ValuePtr update(F && func, B && beforeWrite) {
+		for(;;) {
+			const std::uint64_t expected = loadVersionLock();
+			if(isLocked(expected)) {
+				std::this_thread::yield();
+				continue;
+			}
+			ValuePtr newValuePtr = std::make_shared<const T>(func(*loadPtr()));
+			beforeWrite(*newValuePtr);
+			if(tryLockIfUnchanged(expected)) {
+				const std::uint64_t newVersion = getTransactionClock().fetch_add(1, std::memory_order_acq_rel) + 1;
+				publish(newValuePtr);
+				unlock(newVersion);
+				return newValuePtr;
+			}
+		}
+	}
+
+private:
+	ValuePtr value;
+};
+
+template <typename Type_, typename PoliciesType>
+class AccessorBase <Type_, TransactionalStorage, PoliciesType> : public AccessorRoot<Type_, PoliciesType>
+{
+private:
+	using super = AccessorRoot<Type_, PoliciesType>;
+	using ValueType = typename std::remove_cv<typename std::remove_reference<Type_>::type>::type;
+
+	static_assert(! std::is_reference<Type_>::value, "TransactionalStorage can't return reference.");
+
+public:
+	using GetterType = typename super::GetterType;
+	using SetterType = typename super::SetterType;
+
+public:
+	AccessorBase(const ValueType & newValue = ValueType())
+		:
+			super(makeGetter(), makeSetter()),
+			cell(newValue)
+	{
+	}
+
+	AccessorBase(const AccessorBase & other)
+		:
+			super(makeGetter(), makeSetter()),
+			cell(other.cell.load())
+	{
+	}
+
+	// Same as directGet in InternalStorage, but returns a copy since the value
+	// may be replaced by other threads.
+	ValueType directGet() const {
+		return cell.load();
+	}
+
+	// This doesn't respect "readOnly".
+	void directSet(const ValueType & newValue) {
+		cell.store(newValue);
+	}
+
+	TransactionalCell<ValueType> & getTransactionalCell() {
+		return cell;
+	}
+
+	const TransactionalCell<ValueType> & getTransactionalCell() const {
+		return cell;
+	}
+
+protected:
+	template <typename F, typename B, typename A>
+	void doUpdate(F && func, B && beforeWrite, A && afterWrite, void * /*instance*/) {
+		const std::shared_ptr<const ValueType> newValue = cell.update(std::forward<F>(func), std::forward<B>(beforeWrite));
+		afterWrite(*newValue);
+	}
+
+private:
+	GetterType makeGetter() {
+		return GetterType([this]() -> ValueType {
+			return this->cell.load();
+		});
+	}
+
+	SetterType makeSetter() {
+		return SetterType([this](const ValueType & newValue) {
+			this->cell.store(newValue);
+		});
+	}
+
+private:
+	TransactionalCell<ValueType> cell;
+};
+
+} // namespace private_
+
+template <typename ExceptionPolicy = DefaultExceptionPolicy, typename F>
+void transact(F && func);
+
+// A transaction reads and writes accessors using TransactionalStorage.
+// Reads are optimistic and validated by version. Writes are buffered and
+// published atomically in commit(). If any accessor read or written in the transaction
+// is changed by other threads, the transaction fails and should be retried.
+// Usually transact() should be used instead of using Transaction directly.
+class Transaction
+{
+private:
+	using AbortFunc = void (*)();
+
+	struct ReadEntry
+	{
+		const private_::TransactionalCellBase * cell;
+		std::uint64_t versionLock;
+	};
+
+	struct WriteEntry
+	{
+		private_::TransactionalCellBase * cell;
+		std::shared_ptr<const void> value;
+		void (*publish)(private_::TransactionalCellBase * cell, const std::shared_ptr<const void> & value);
+		std::function<void ()> notify;
+		std::uint64_t lockedFrom;
+	};
+
+public:
+	Transaction()
+		: Transaction(nullptr)
+	{
+	}
+
+	Transaction(const Transaction &) = delete;
+	Transaction & operator = (const Transaction &) = delete;
+
+	// Return false if a conflict is detected. The values read after a conflict may be inconsistent,
+	// the transaction should be retried. In transact(), get aborts the transaction body on a conflict
+	// instead, unless the NoExceptions policy is used.
+	bool isValid() const {
+		return valid;
+	}
+
+	template <typename T, typename P>
+	T get(const Accessor<T, P> & accessor) {
+		using ValueType = typename std::remove_cv<T>::type;
+
+		const auto & cell = accessor.getTransactionalCell();
+		const WriteEntry * writeEntry = findWriteEntry(&cell);
+		if(writeEntry != nullptr) {
+			return *static_cast<const ValueType *>(writeEntry->value.get());
+		}
+
+		const std::uint64_t before = cell.loadVersionLock();
+		std::shared_ptr<const ValueType> value = cell.loadPtr();
+		const std::uint64_t after = cell.loadVersionLock();
+		if(before != after
+			|| private_::TransactionalCellBase::isLocked(before)
+			|| private_::TransactionalCellBase::getVersion(before) > readVersion
+		) {
+			valid = false;
+		}
+		if(! valid) {
+			abortOnConflict();
+		}
+		readList.push_back(ReadEntry { &cell, before });
+		return *value;
+	}
+
+	// The value is published in commit(). The OnChangedCallback of the accessor is invoked
+	// after the transaction is committed. OnChangingCallback is not invoked.
+	template <typename T, typename P>
+	void set(Accessor<T, P> & accessor, const typename Accessor<T, P>::ValueType & newValue) {
+		using ValueType = typename std::remove_cv<T>::type;
+
+		if(! private_::AccessorFriend::checkWritable(accessor)) {
+			return;
+		}
+
+		auto & cell = accessor.getTransactionalCell();
+		std::shared_ptr<const ValueType> value = std::make_shared<const ValueType>(newValue);
+		WriteEntry * writeEntry = findWriteEntry(&cell);
+		if(writeEntry == nullptr) {
+			writeList.push_back(WriteEntry {
+				&cell,
+				value,
+				&doPublish<ValueType>,
+				std::function<void ()>(),
+				0
+			});
+			writeEntry = &writeList.back();
+		}
+		writeEntry->value = value;
+		Accessor<T, P> * accessorPtr = &accessor;
+		writeEntry->notify = [accessorPtr, value]() {
+			private_::AccessorFriend::invokeOnChanged(*accessorPtr, *value);
+		};
+	}
+
+	// Return true if the transaction is committed. After commit, the transaction can't be used any more.
+	bool commit() {
+		if(! valid) {
+			return false;
+		}
+		if(writeList.empty()) {
+			return true;
+		}
+
+		// Lock in address order to avoid dead lock.
+		std::sort(writeList.begin(), writeList.end(), [](const WriteEntry & a, const WriteEntry & b) {
+			return a.cell < b.cell;
+		});
+		for(std::size_t i = 0; i < writeList.size(); ++i) {
+			if(! writeList[i].cell->tryLock(writeList[i].lockedFrom)) {
+				unlockWriteList(i);
+				valid = false;
+				return false;
+			}
+		}
+
+		const std::uint64_t writeVersion = private_::getTransactionClock().fetch_add(1, std::memory_order_acq_rel) + 1;
+
+		// If no other transaction is committed since this transaction began, the reads are still valid.
+		if(writeVersion != readVersion + 1) {
+			for(const ReadEntry & readEntry : readList) {
+				const WriteEntry * writeEntry = findWriteEntry(readEntry.cell);
+				const std::uint64_t current = (writeEntry != nullptr ? writeEntry->lockedFrom : readEntry.cell->loadVersionLock());
+				if(current != readEntry.versionLock) {
+					unlockWriteList(writeList.size());
+					valid = false;
+					return false;
+				}
+			}
+		}
+
+		for(WriteEntry & writeEntry : writeList) {
+			writeEntry.publish(writeEntry.cell, writeEntry.value);
+		}
+		for(WriteEntry & writeEntry : writeList) {
+			writeEntry.cell->unlock(writeVersion);
+		}
+
+		valid = false;
+		for(WriteEntry & writeEntry : writeList) {
+			writeEntry.notify();
+		}
+		return true;
+	}
+
+private:
+	explicit Transaction(const AbortFunc abortBody)
+		:
+			readVersion(private_::getTransactionClock().load(std::memory_order_acquire)),
+			valid(true),
+			abortBody(abortBody),
+			readList(),
+			writeList()
+	{
+	}
+
+	void abortOnConflict() const {
+		if(abortBody != nullptr) {
+			abortBody();
+		}
+	}
+
+	template <typename T>
+	static void doPublish(private_::TransactionalCellBase * cell, const std::shared_ptr<const void> & value) {
+		static_cast<private_::TransactionalCell<T> *>(cell)->publish(std::static_pointer_cast<const T>(value));
+	}
+
+	WriteEntry * findWriteEntry(const private_::TransactionalCellBase * cell) {
+		for(WriteEntry & writeEntry : writeList) {
+			if(writeEntry.cell == cell) {
+				return &writeEntry;
+			}
+		}
+		return nullptr;
+	}
+
+	void unlockWriteList(const std::size_t count) {
+		for(std::size_t i = 0; i < count; ++i) {
+			writeList[i].cell->unlockUnchanged(writeList[i].lockedFrom);
+		}
+	}
+
+private:
+	const std::uint64_t readVersion;
+	bool valid;
+	const AbortFunc abortBody;
+	std::vector<ReadEntry> readList;
+	std::vector<WriteEntry> writeList;
+
+	template <typename ExceptionPolicy, typename F>
+	friend void transact(F && func);
+};
+
+// Invoke func(Transaction &) and commit the transaction, retry until the commit succeeds.
+// func may be invoked multiple times, it should not have side effects other than
+// reading and writing accessors through the transaction.
+// If a read in func conflicts, func is aborted and retried immediately, so it never
+// continues with inconsistent values. The abort is an exception which transact catches,
+// func must not catch all exceptions without rethrowing.
+// With transact<NoExceptions>, func runs to the end and the conflict is detected in commit,
+// func should check isValid() before relying on the consistency of the values read.
+template <typename ExceptionPolicy, typename F>
+void transact(F && func)
+{
+	using Body = private_::TransactionBody<ExceptionPolicy>;
+
+	for(;;) {
+		Transaction transaction(Body::getAbort());
+		if(Body::run(func, transaction) && transaction.commit()) {
+			return;
+		}
+		std::this_thread::yield();
+	}
+}
+
+
+} // namespace accessorpp
+
+#endif
@@ -0,0 +1,425 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCESSORPP_VERSIONEDOBJECT_H_264018573926
+#define ACCESSORPP_VERSIONEDOBJECT_H_264018573926
+
+#include "accessorpp/accessorcore.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace accessorpp {
+
+// The value is stored in a VersionedObject. All accessors using VersionedStorage
+// in the same VersionedObject can be read at one instant using a VersionedSnapshot.
+struct VersionedStorage {};
+
+class VersionedObject;
+
+namespace private_ {
+
+// The serial is unique for each accessor in the object, so a snapshot can tell
+// the accessor which owns a reused slot from the one which owned it before.
+struct VersionedSlot
+{
+	std::size_t index;
+	std::uint64_t serial;
+};
+
+struct VersionedCell
+{
+	std::shared_ptr<const void> value;
+	std::uint64_t serial;
+};
+
+// The slots are stored in fixed size chunks. A write copies the list of the chunk
+// pointers and the chunk containing the slot, the other chunks are shared between versions.
+enum { versionedChunkSize = 32 };
+
+using VersionedChunk = std::vector<VersionedCell>;
+
+struct VersionedState
+{
+	const VersionedCell & getCell(const std::size_t slot) const {
+		return (*chunkList[slot / versionedChunkSize])[slot % versionedChunkSize];
+	}
+
+	std::uint64_t version;
+	std::size_t slotCount;
+	// The chunks of a published state are never changed.
+	std::vector<std::shared_ptr<VersionedChunk> > chunkList;
+};
+
+} // namespace private_
+
+// A VersionedSnapshot holds one version of all values in a VersionedObject.
+// Holding a snapshot doesn't block writers. The version is freed when
+// the last snapshot referring it is destroyed.
+class VersionedSnapshot
+{
+private:
+	using State = private_::VersionedState;
+
+public:
+	VersionedSnapshot()
+		: object(nullptr), state()
+	{
+	}
+
+	bool isValid() const {
+		return state != nullptr;
+	}
+
+	// The version increases by one for each write to the object.
+	std::uint64_t getVersion() const {
+		return state->version;
+	}
+
+	// The accessor must belong to the object the snapshot is taken from,
+	// and must be created before the snapshot is taken.
+	template <typename T, typename P>
+	const typename std::remove_cv<T>::type & get(const Accessor<T, P> & accessor) const {
+		const private_::VersionedSlot slot = accessor.getVersionedSlot();
+		if(&accessor.getVersionedObject() != object
+			|| slot.index >= state->slotCount
+			|| state->getCell(slot.index).serial != slot.serial
+		) {
+			private_::handleFatalError<typename private_::GetErrorHandler<P>::Type>(ErrorCode::foreignAccessor);
+		}
+		return *static_cast<const typename std::remove_cv<T>::type *>(state->getCell(slot.index).value.get());
+	}
+
+private:
+	VersionedSnapshot(const VersionedObject * object, std::shared_ptr<const State> state)
+		: object(object), state(std::move(state))
+	{
+	}
+
+private:
+	const VersionedObject * object;
+	std::shared_ptr<const State> state;
+
+	friend class VersionedObject;
+};
+
+// VersionedObject keeps multiple versions of the values of the accessors using VersionedStorage.
+// Each write publishes a new version, the values which are not changed are shared between versions.
+// Readers take snapshots without the mutex, writers are serialized by the mutex.
+// The slots of the destroyed accessors are reused.
+class VersionedObject
+{
+private:
+	using State = private_::VersionedState;
+	using StatePtr = std::shared_ptr<const State>;
+
+public:
+	VersionedObject()
+		:
+			state(std::make_shared<const State>(State { 0, 0, {} })),
+			mutex(),
+			batchThread(),
+			batchState(),
+			ownedChunkList(),
+			freeSlotList(),
+			serialCounter(0)
+	{
+	}
+
+	VersionedObject(const VersionedObject &) = delete;
+	VersionedObject & operator = (const VersionedObject &) = delete;
+
+	VersionedSnapshot snapshot() const {
+		return VersionedSnapshot(this, loadState());
+	}
+
+	std::uint64_t getVersion() const {
+		return loadState()->version;
+	}
+
+	// The number of the slots, including the free slots which will be reused.
+	std::size_t getSlotCount() const {
+		return loadState()->slotCount;
+	}
+
+	// Invoke func(), all writes in func are published as one version.
+	// Snapshots never see part of the writes.
+	template <typename F>
+	void batch(F && func) {
+		if(isInBatch()) {
+			func();
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		batchState = std::make_shared<State>(*state);
+		++batchState->version;
+		beginWrite(*batchState);
+		batchThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+		// If func throws, the writes are discarded.
+		BatchGuard guard(*this);
+		func();
+		storeState(batchState);
+	}
+
+	// Below functions are used by VersionedStorage.
+	private_::VersionedSlot allocateSlot(std::shared_ptr<const void> value) {
+		return doWrite([this, &value](State & newState) {
+			std::size_t index;
+			if(! freeSlotList.empty()) {
+				index = freeSlotList.back();
+				freeSlotList.pop_back();
+			}
+			else {
+				index = newState.slotCount++;
+			}
+			private_::VersionedCell & cell = getWritableCell(newState, index);
+			cell.value = std::move(value);
+			cell.serial = ++serialCounter;
+			return private_::VersionedSlot { index, cell.serial };
+		});
+	}
+
+	// The value is released now, the old versions keep it until they are freed.
+	void freeSlot(const std::size_t slot) {
+		doWrite([this, slot](State & newState) {
+			private_::VersionedCell & cell = getWritableCell(newState, slot);
+			cell.value.reset();
+			cell.serial = 0;
+			freeSlotList.push_back(slot);
+			return slot;
+		});
+	}
+
+	void store(const std::size_t slot, std::shared_ptr<const void> value) {
+		doWrite([this, slot, &value](State & newState) {
+			getWritableCell(newState, slot).value = std::move(value);
+			return slot;
+		});
+	}
+
+	// func is "std::shared_ptr<const void> (const std::shared_ptr<const void> & oldValue)".
+	// It's invoked out of the lock, and invoked again if the slot is changed by others meanwhile.
+	template <typename F>
+	std::shared_ptr<const void> update(const std::size_t slot, F && func) {
+		if(isInBatch()) {
+			std::shared_ptr<const void> newValue = func(batchState->getCell(slot).value);
+			getWritableCell(*batchState, slot).value = newValue;
+			return newValue;
+		}
+
+		for(;;) {
+			const std::shared_ptr<const void> oldValue = loadState()->getCell(slot).value;
+			std::shared_ptr<const void> newValue = func(oldValue);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			// oldValue is kept alive, so the address can't be reused by another value.
+			if(state->getCell(slot).value != oldValue) {
+				continue;
+			}
+			std::shared_ptr<State> newState = std::make_shared<State>(*state);
+			++newState->version;
+			beginWrite(*newState);
+			getWritableCell(*newState, slot).value = newValue;
+			storeState(newState);
+			return newValue;
+		}
+	}
+
+	std::shared_ptr<const void> load(const std::size_t slot) const {
+		if(isInBatch()) {
+			return batchState->getCell(slot).value;
+		}
+		return loadState()->getCell(slot).value;
+	}
+
+private:
+	template <typename F>
+	auto doWrite(F && func) -> decltype(func(std::declval<State &>())) {
+		if(isInBatch()) {
+			return func(*batchState);
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		std::shared_ptr<State> newState = std::make_shared<State>(*state);
+		++newState->version;
+		beginWrite(*newState);
+		auto result = func(*newState);
+		storeState(newState);
+		return result;
+	}
+
+	// Must be called with the mutex locked. All chunks of newState are shared with
+	// the published state, until getWritableCell copies them.
+	void beginWrite(const State & newState) {
+		ownedChunkList.assign(newState.chunkList.size(), false);
+	}
+
+	// Must be called with the mutex locked. Each chunk is copied once per write, or once per batch.
+	private_::VersionedCell & getWritableCell(State & newState, const std::size_t slot) {
+		const std::size_t chunkIndex = slot / private_::versionedChunkSize;
+		if(chunkIndex >= newState.chunkList.size()) {
+			newState.chunkList.push_back(std::make_shared<private_::VersionedChunk>(
+				(std::size_t)private_::versionedChunkSize,
+				private_::VersionedCell { std::shared_ptr<const void>(), 0 }
+			));
+			ownedChunkList.push_back(true);
+		}
+		else if(! ownedChunkList[chunkIndex]) {
+			newState.chunkList[chunkIndex] = std::make_shared<private_::VersionedChunk>(*newState.chunkList[chunkIndex]);
+			ownedChunkList[chunkIndex] = true;
+		}
+		return (*newState.chunkList[chunkIndex])[slot % private_::versionedChunkSize];
+	}
+
+	bool isInBatch() const {
+		return batchThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+	}
+
+	struct BatchGuard
+	{
+		explicit BatchGuard(VersionedObject & object) : object(object) {
+		}
+
+		~BatchGuard() {
+			object.batchThread.store(std::thread::id(), std::memory_order_relaxed);
+			object.batchState.reset();
+		}
+
+		VersionedObject & object;
+	};
+
+	// std::atomic_load on shared_ptr is not lock free in the major standard libraries,
+	// it uses a small pool of spin locks or mutexes keyed by the address.
+	StatePtr loadState() const {
+		return std::atomic_load_explicit(&state, std::memory_order_acquire);
+	}
+
+	// Must be called with the mutex locked.
+	void storeState(StatePtr newState) {
+		std::atomic_store_explicit(&state, std::move(newState), std::memory_order_release);
+	}
+
+private:
+	StatePtr state;
+	std::mutex mutex;
+	std::atomic<std::thread::id> batchThread;
+	std::shared_ptr<State> batchState;
+	// Below are guarded by the mutex.
+	std::vector<bool> ownedChunkList;
+	std::vector<std::size_t> freeSlotList;
+	std::uint64_t serialCounter;
+};
+
+namespace private_ {
+
+template <typename Type_, typename PoliciesType>
+class AccessorBase <Type_, VersionedStorage, PoliciesType> : public AccessorRoot<Type_, PoliciesType>
+{
+private:
+	using super = AccessorRoot<Type_, PoliciesType>;
+	using ValueType = typename std::remove_cv<typename std::remove_reference<Type_>::type>::type;
+
+	static_assert(! std::is_reference<Type_>::value, "VersionedStorage can't return reference.");
+
+public:
+	using GetterType = typename super::GetterType;
+	using SetterType = typename super::SetterType;
+
+public:
+	explicit AccessorBase(VersionedObject & object, const ValueType & newValue = ValueType())
+		:
+			super(makeGetter(), makeSetter()),
+			object(&object),
+			slot(object.allocateSlot(std::make_shared<const ValueType>(newValue)))
+	{
+	}
+
+	// The copy uses a new slot in the same object, the value is shared until either is set.
+	AccessorBase(const AccessorBase & other)
+		:
+			super(makeGetter(), makeSetter()),
+			object(other.object),
+			slot(object->allocateSlot(object->load(other.slot.index)))
+	{
+	}
+
+	// The slot is reused by the accessors created later.
+	~AccessorBase() {
+		object->freeSlot(slot.index);
+	}
+
+	// Returns a copy since the value may be replaced by other threads.
+	ValueType directGet() const {
+		return *static_cast<const ValueType *>(object->load(slot.index).get());
+	}
+
+	// This doesn't respect "readOnly".
+	void directSet(const ValueType & newValue) {
+		object->store(slot.index, std::make_shared<const ValueType>(newValue));
+	}
+
+	VersionedObject & getVersionedObject() const {
+		return *object;
+	}
+
+	VersionedSlot getVersionedSlot() const {
+		return slot;
+	}
+
+protected:
+	template <typename F, typename B, typename A>
+	void doUpdate(F && func, B && beforeWrite, A && afterWrite, void * /*instance*/) {
+		const std::shared_ptr<const void> newValue = object->update(slot.index,
+			[&func, &beforeWrite](const std::shared_ptr<const void> & oldValue) -> std::shared_ptr<const void> {
+				std::shared_ptr<const ValueType> newValue = std::make_shared<const ValueType>(
+					func(*static_cast<const ValueType *>(oldValue.get()))
+				);
+				beforeWrite(*newValue);
+				return newValue;
+			}
+		);
+		afterWrite(*static_cast<const ValueType *>(newValue.get()));
+	}
+
+private:
+	GetterType makeGetter() {
+		return GetterType([this]() -> ValueType {
+			return this->directGet();
+		});
+	}
+
+	SetterType makeSetter() {
+		return SetterType([this](const ValueType & newValue) {
+			this->directSet(newValue);
+		});
+	}
+
+private:
+	VersionedObject * object;
+	VersionedSlot slot;
+};
+
+} // namespace private_
+
+
+} // namespace accessorpp
+
+#endif
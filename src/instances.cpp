@@ -0,0 +1,22 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The explicit instantiations declared in accessorpp/instances.h.
+
+#include "accessorpp/instances.h"
+
+#define ACCESSORPP_INSTANTIATE_COMMON_INSTANCE(Type) \
+	ACCESSORPP_INSTANTIATE_SETTER(Type) \
+	ACCESSORPP_INSTANTIATE_ACCESSOR(Type, accessorpp::DefaultPolicies)
+
+ACCESSORPP_COMMON_INSTANCE_TYPES(ACCESSORPP_INSTANTIATE_COMMON_INSTANCE)
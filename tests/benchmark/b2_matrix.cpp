@@ -0,0 +1,423 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/computed.h"
+#include "accessorpp/concurrentcallbacklist.h"
+#include "accessorpp/instrumentation.h"
+#include "accessorpp/trace.h"
+
+#include <string>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Pod64
+{
+	int64_t data[8];
+};
+
+static_assert(sizeof(Pod64) == 64, "");
+
+template <typename T>
+struct ValueTraits;
+
+template <>
+struct ValueTraits<int>
+{
+	static const char * getName() {
+		return "int";
+	}
+
+	static int make(const uint64_t i) {
+		return (int)i;
+	}
+};
+
+template <>
+struct ValueTraits<Pod64>
+{
+	static const char * getName() {
+		return "pod64";
+	}
+
+	static Pod64 make(const uint64_t i) {
+		Pod64 pod = {};
+		pod.data[0] = (int64_t)i;
+		return pod;
+	}
+};
+
+template <>
+struct ValueTraits<std::string>
+{
+	static const char * getName() {
+		return "string";
+	}
+
+	// Longer than the small string buffer, so each copy allocates.
+	static std::string make(const uint64_t i) {
+		return std::string(48, (char)('a' + i % 26));
+	}
+};
+
+template <typename T>
+struct Holder
+{
+	NON_INLINE T getValue() const {
+		return value;
+	}
+
+	NON_INLINE void setValue(const T & newValue) {
+		value = newValue;
+	}
+
+	T value;
+};
+
+template <typename T>
+struct VirtualInterface
+{
+	virtual ~VirtualInterface() {
+	}
+
+	virtual T getValue() const = 0;
+	virtual void setValue(const T & newValue) = 0;
+};
+
+template <typename T>
+struct VirtualImplement : VirtualInterface<T>
+{
+	T getValue() const override {
+		return value;
+	}
+
+	void setValue(const T & newValue) override {
+		value = newValue;
+	}
+
+	T value;
+};
+
+template <typename T>
+struct GlobalHolder
+{
+	static Holder<T> holder;
+};
+
+template <typename T>
+Holder<T> GlobalHolder<T>::holder {};
+
+template <typename T>
+T freeGet()
+{
+	return GlobalHolder<T>::holder.value;
+}
+
+template <typename T>
+void freeSet(const T & newValue)
+{
+	GlobalHolder<T>::holder.value = newValue;
+}
+
+struct ExternalPolicies
+{
+	using Storage = accessorpp::ExternalStorage;
+};
+
+// Same as the default policies, the instrumentation must compile away.
+struct NoInstrumentationPolicies
+{
+	using Instrumentation = accessorpp::NoInstrumentation;
+};
+
+static_assert(sizeof(accessorpp::Accessor<int, NoInstrumentationPolicies>) == sizeof(accessorpp::Accessor<int>), "");
+
+struct CountAccessesPolicies
+{
+	using Instrumentation = accessorpp::CountAccesses;
+};
+
+struct CountAccessesPerThreadPolicies
+{
+	using Instrumentation = accessorpp::CountAccessesPerThread;
+};
+
+// The tracing is never enabled in the benchmark, it measures the cost of the disabled hooks.
+struct TraceDisabledPolicies
+{
+	using Instrumentation = accessorpp::TraceAccesses;
+};
+
+struct CallbackPolicies
+{
+	using OnChangingCallback = std::function<void ()>;
+	using OnChangedCallback = std::function<void ()>;
+};
+
+template <typename T>
+struct CallbackDataPolicies
+{
+	using OnChangingCallback = std::function<void (const T &, int)>;
+	using OnChangedCallback = std::function<void (const T &, int)>;
+	using CallbackData = int;
+};
+
+// The values are prepared before measuring, so constructing std::string is not measured.
+template <typename T>
+struct ValueList
+{
+	ValueList() : valueList() {
+		for(uint64_t i = 0; i < size; ++i) {
+			valueList.push_back(ValueTraits<T>::make(i));
+		}
+	}
+
+	const T & operator[] (const uint64_t i) const {
+		return valueList[i % size];
+	}
+
+	static constexpr uint64_t size = 16;
+	std::vector<T> valueList;
+};
+
+template <typename T, typename Get, typename Set>
+void measureConfig(const std::string & name, Get get, Set set)
+{
+	const ValueList<T> valueList;
+	measureNanoseconds(ValueTraits<T>::getName(), name, "get", [&get](const uint64_t) {
+		doNotOptimize(get());
+	});
+	measureNanoseconds(ValueTraits<T>::getName(), name, "set", [&set, &valueList](const uint64_t i) {
+		set(valueList[i]);
+		clobberMemory();
+	});
+}
+
+template <typename T>
+void measureValueType()
+{
+	{
+		Holder<T> holder {};
+		measureConfig<T>("native",
+			[&holder]() -> T { return holder.value; },
+			[&holder](const T & value) { holder.value = value; }
+		);
+	}
+	{
+		std::unique_ptr<VirtualInterface<T> > object(new VirtualImplement<T>());
+		VirtualInterface<T> * pointer = object.get();
+		doNotOptimize(pointer);
+		measureConfig<T>("virtual",
+			[pointer]() -> T { return pointer->getValue(); },
+			[pointer](const T & value) { pointer->setValue(value); }
+		);
+	}
+	{
+		accessorpp::Accessor<T> accessor;
+		measureConfig<T>("internal",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		accessorpp::Accessor<T, NoInstrumentationPolicies> accessor;
+		measureConfig<T>("internal no instrumentation",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		accessorpp::Accessor<T, CountAccessesPolicies> accessor;
+		measureConfig<T>("internal count accesses",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		accessorpp::Accessor<T, CountAccessesPerThreadPolicies> accessor;
+		measureConfig<T>("internal count accesses per thread",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		accessorpp::Accessor<T, TraceDisabledPolicies> accessor;
+		measureConfig<T>("internal trace disabled",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		accessorpp::Accessor<T, CallbackPolicies> accessor;
+		int changeCount = 0;
+		accessor.onChanging() = [&changeCount]() { ++changeCount; };
+		accessor.onChanged() = [&changeCount]() { ++changeCount; };
+		measureConfig<T>("internal callbacks",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+		doNotOptimize(changeCount);
+	}
+	{
+		accessorpp::Accessor<T, CallbackDataPolicies<T> > accessor;
+		int changeCount = 0;
+		accessor.onChanging() = [&changeCount](const T &, const int data) { changeCount += data; };
+		accessor.onChanged() = [&changeCount](const T &, const int data) { changeCount += data; };
+		measureConfig<T>("internal callback data",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.setWithCallbackData(value, 1); }
+		);
+		doNotOptimize(changeCount);
+	}
+	{
+		Holder<T> holder {};
+		accessorpp::Accessor<T, ExternalPolicies> accessor(&holder.value, &holder.value);
+		measureConfig<T>("external address",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		Holder<T> holder {};
+		accessorpp::Accessor<T, ExternalPolicies> accessor(
+			&Holder<T>::value, &holder, &Holder<T>::value, &holder
+		);
+		measureConfig<T>("external member bound",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		Holder<T> holder {};
+		accessorpp::Accessor<T, ExternalPolicies> accessor(
+			&Holder<T>::value, &Holder<T>::value
+		);
+		measureConfig<T>("external member unbound",
+			[&accessor, &holder]() -> T { return accessor.get(&holder); },
+			[&accessor, &holder](const T & value) { accessor.set(value, &holder); }
+		);
+	}
+	{
+		accessorpp::Accessor<T, ExternalPolicies> accessor(
+			&freeGet<T>, &freeSet<T>
+		);
+		measureConfig<T>("external free function",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		Holder<T> holder {};
+		accessorpp::Accessor<T, ExternalPolicies> accessor(
+			&Holder<T>::getValue, &holder, &Holder<T>::setValue, &holder
+		);
+		measureConfig<T>("external member function bound",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+	{
+		Holder<T> holder {};
+		accessorpp::Accessor<T, ExternalPolicies> accessor(
+			&Holder<T>::getValue, &Holder<T>::setValue
+		);
+		measureConfig<T>("external member function unbound",
+			[&accessor, &holder]() -> T { return accessor.get(&holder); },
+			[&accessor, &holder](const T & value) { accessor.set(value, &holder); }
+		);
+	}
+	{
+		Holder<T> holder {};
+		accessorpp::Accessor<T, ExternalPolicies> accessor(
+			[&holder]() -> T { return holder.value; },
+			[&holder](const T & value) { holder.value = value; }
+		);
+		measureConfig<T>("external lambda",
+			[&accessor]() -> T { return accessor.get(); },
+			[&accessor](const T & value) { accessor.set(value); }
+		);
+	}
+}
+
+struct ComputedSourcePolicies
+{
+	using OnChangedCallback = accessorpp::ConcurrentCallbackList<void (int)>;
+};
+
+struct ComputedPolicies
+{
+	using Storage = accessorpp::ComputedStorage;
+};
+
+// The derived value which is not trivial to compute.
+int computeDerived(const std::vector<int> & weightList, const int width, const int height)
+{
+	int result = 0;
+	for(const int weight : weightList) {
+		result += weight * width + height;
+	}
+	return result;
+}
+
+} // namespace
+
+TEST_CASE("b2, ns/op matrix")
+{
+	measureValueType<int>();
+	measureValueType<Pod64>();
+	measureValueType<std::string>();
+}
+
+TEST_CASE("b2, computed accessor")
+{
+	const std::vector<int> weightList(64, 3);
+	accessorpp::Accessor<int, ComputedSourcePolicies> width(2);
+	accessorpp::Accessor<int, ComputedSourcePolicies> height(3);
+	doNotOptimize(&weightList);
+
+	// The derived value is computed by the getter on every get.
+	accessorpp::Accessor<int> recomputed(
+		[&weightList, &width, &height]() { return computeDerived(weightList, width, height); },
+		accessorpp::noSetter
+	);
+	accessorpp::Accessor<int, ComputedPolicies> computed(
+		[&weightList, &width, &height]() { return computeDerived(weightList, width, height); },
+		width,
+		height
+	);
+
+	measureNanoseconds("computed", "recompute getter", "get", [&recomputed](const uint64_t) {
+		doNotOptimize(recomputed.get());
+	});
+	measureNanoseconds("computed", "computed", "get", [&computed](const uint64_t) {
+		doNotOptimize(computed.get());
+	});
+
+	// One source change per 100 reads.
+	measureNanoseconds("computed", "recompute getter", "get, 1% set", [&recomputed, &width](const uint64_t i) {
+		if(i % 100 == 0) {
+			width = (int)i;
+		}
+		doNotOptimize(recomputed.get());
+	});
+	measureNanoseconds("computed", "computed", "get, 1% set", [&computed, &width](const uint64_t i) {
+		if(i % 100 == 0) {
+			width = (int)i;
+		}
+		doNotOptimize(computed.get());
+	});
+}
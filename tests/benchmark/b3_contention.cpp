@@ -0,0 +1,381 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/concurrentcallbacklist.h"
+#include "accessorpp/instrumentation.h"
+#include "accessorpp/threadcached.h"
+#include "accessorpp/transaction.h"
+#include "accessorpp/versionedobject.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Each configuration runs for ACCESSORPP_BENCHMARK_CONTENTION_MS milliseconds, default is 50.
+// The thread counts are 1, 2, 4... up to the hardware concurrency,
+// or ACCESSORPP_BENCHMARK_MAX_THREADS if it's set.
+
+namespace {
+
+// The latency is sampled per batch, timing each single operation would measure the clock instead.
+constexpr int batchSize = 32;
+
+enum class Role
+{
+	reader,
+	writer
+};
+
+struct ThreadResult
+{
+	Role role;
+	uint64_t operationCount;
+	std::vector<double> latencyList;
+};
+
+int getEnvironmentInt(const char * name, const int defaultValue)
+{
+	const char * value = std::getenv(name);
+	if(value == nullptr || *value == 0) {
+		return defaultValue;
+	}
+	return std::atoi(value);
+}
+
+std::vector<int> getThreadCountList()
+{
+	int maxThreadCount = (int)std::thread::hardware_concurrency();
+	if(maxThreadCount <= 0) {
+		maxThreadCount = 4;
+	}
+	maxThreadCount = getEnvironmentInt("ACCESSORPP_BENCHMARK_MAX_THREADS", maxThreadCount);
+
+	std::vector<int> result;
+	for(int count = 1; count < maxThreadCount; count *= 2) {
+		result.push_back(count);
+	}
+	result.push_back(maxThreadCount);
+	return result;
+}
+
+double getPercentile(const std::vector<double> & sortedList, const double percentile)
+{
+	if(sortedList.empty()) {
+		return 0;
+	}
+	const std::size_t index = (std::size_t)(percentile * (double)(sortedList.size() - 1));
+	return sortedList[index];
+}
+
+void report(
+		const std::string & group,
+		const std::string & name,
+		const Role role,
+		const std::vector<ThreadResult> & threadResultList,
+		const double elapsedNanoseconds
+	)
+{
+	uint64_t operationCount = 0;
+	int threadCount = 0;
+	std::vector<double> latencyList;
+	for(const ThreadResult & threadResult : threadResultList) {
+		if(threadResult.role != role) {
+			continue;
+		}
+		++threadCount;
+		operationCount += threadResult.operationCount;
+		latencyList.insert(latencyList.end(), threadResult.latencyList.begin(), threadResult.latencyList.end());
+	}
+	if(threadCount == 0 || operationCount == 0) {
+		return;
+	}
+	std::sort(latencyList.begin(), latencyList.end());
+
+	BenchmarkReport::getInstance().add({
+		group,
+		name,
+		role == Role::reader ? "read" : "write",
+		elapsedNanoseconds * threadCount / (double)operationCount,
+		operationCount,
+		{
+			{ "threads", (double)threadCount },
+			{ "opsPerSecond", (double)operationCount * 1e9 / elapsedNanoseconds },
+			{ "p50", getPercentile(latencyList, 0.5) },
+			{ "p99", getPercentile(latencyList, 0.99) },
+			{ "p999", getPercentile(latencyList, 0.999) }
+		}
+	});
+}
+
+// read(threadIndex) and write(threadIndex, i) are invoked concurrently by
+// readerCount reader threads and writerCount writer threads.
+template <typename R, typename W>
+void runContention(
+		const std::string & group,
+		const std::string & name,
+		const int readerCount,
+		const int writerCount,
+		R read,
+		W write
+	)
+{
+	const int threadCount = readerCount + writerCount;
+	const int durationMilliseconds = getEnvironmentInt("ACCESSORPP_BENCHMARK_CONTENTION_MS", 50);
+
+	std::vector<ThreadResult> threadResultList(threadCount);
+	std::atomic<int> readyCount(0);
+	std::atomic<bool> started(false);
+	std::atomic<bool> stopped(false);
+
+	std::vector<std::thread> threadList;
+	for(int threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+		threadList.emplace_back([=, &threadResultList, &readyCount, &started, &stopped, &read, &write]() {
+			using Clock = std::chrono::steady_clock;
+
+			ThreadResult & threadResult = threadResultList[threadIndex];
+			threadResult.role = (threadIndex < readerCount ? Role::reader : Role::writer);
+			threadResult.operationCount = 0;
+			threadResult.latencyList.reserve(1024 * 64);
+
+			++readyCount;
+			while(! started.load(std::memory_order_acquire)) {
+			}
+
+			uint64_t i = 0;
+			while(! stopped.load(std::memory_order_relaxed)) {
+				const Clock::time_point start = Clock::now();
+				if(threadResult.role == Role::reader) {
+					for(int k = 0; k < batchSize; ++k) {
+						doNotOptimize(read(threadIndex));
+					}
+				}
+				else {
+					for(int k = 0; k < batchSize; ++k) {
+						write(threadIndex, i++);
+						clobberMemory();
+					}
+				}
+				const double elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+				threadResult.operationCount += batchSize;
+				if(threadResult.latencyList.size() < threadResult.latencyList.capacity()) {
+					threadResult.latencyList.push_back(elapsed / batchSize);
+				}
+			}
+		});
+	}
+
+	while(readyCount.load() < threadCount) {
+		std::this_thread::yield();
+	}
+	const auto start = std::chrono::steady_clock::now();
+	started.store(true, std::memory_order_release);
+	std::this_thread::sleep_for(std::chrono::milliseconds(durationMilliseconds));
+	stopped.store(true, std::memory_order_relaxed);
+	for(std::thread & thread : threadList) {
+		thread.join();
+	}
+	const double elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start
+	).count();
+
+	const std::string fullName = name + " r" + std::to_string(readerCount) + " w" + std::to_string(writerCount);
+	report(group, fullName, Role::reader, threadResultList, elapsed);
+	report(group, fullName, Role::writer, threadResultList, elapsed);
+}
+
+// Run read only, write only, and half readers half writers.
+template <typename R, typename W>
+void runReadWriteMatrix(const std::string & group, const std::string & name, R read, W write)
+{
+	for(const int threadCount : getThreadCountList()) {
+		runContention(group, name, threadCount, 0, read, write);
+		runContention(group, name, 0, threadCount, read, write);
+		if(threadCount > 1) {
+			runContention(group, name, threadCount / 2, threadCount - threadCount / 2, read, write);
+		}
+	}
+}
+
+struct ExternalPolicies
+{
+	using Storage = accessorpp::ExternalStorage;
+};
+
+template <typename I>
+struct InstrumentedPolicies
+{
+	using Storage = accessorpp::ExternalStorage;
+	using Instrumentation = I;
+};
+
+struct ConcurrentCallbackPolicies
+{
+	using Storage = accessorpp::ExternalStorage;
+	using OnChangedCallback = accessorpp::ConcurrentCallbackList<void (int)>;
+};
+
+struct ThreadCachedPolicies
+{
+	using Storage = accessorpp::ThreadCachedStorage;
+};
+
+struct TransactionalPolicies
+{
+	using Storage = accessorpp::TransactionalStorage;
+};
+
+struct VersionedPolicies
+{
+	using Storage = accessorpp::VersionedStorage;
+};
+
+// Internal storage isn't thread safe, so the accessors shared by threads store
+// the value in an atomic via external storage.
+struct AtomicValue
+{
+	AtomicValue() : value(0) {
+	}
+
+	int get() const {
+		return value.load(std::memory_order_relaxed);
+	}
+
+	void set(const int newValue) {
+		value.store(newValue, std::memory_order_relaxed);
+	}
+
+	std::atomic<int> value;
+};
+
+// Adjacent values are 128 bytes apart, so they never share a cache line whatever the alignment is.
+// alignas isn't used because C++11 operator new[] doesn't respect the extended alignment.
+struct PaddedValue
+{
+	AtomicValue value;
+	char padding[128 - sizeof(AtomicValue)];
+};
+
+} // namespace
+
+TEST_CASE("b3, contention, same accessor")
+{
+	AtomicValue value;
+	accessorpp::Accessor<int, ExternalPolicies> accessor(&AtomicValue::get, &value, &AtomicValue::set, &value);
+	runReadWriteMatrix("contention", "same accessor",
+		[&accessor](int) { return accessor.get(); },
+		[&accessor](int, const uint64_t i) { accessor.set((int)i); }
+	);
+}
+
+TEST_CASE("b3, contention, instrumentation counters")
+{
+	{
+		AtomicValue value;
+		accessorpp::Accessor<int, InstrumentedPolicies<accessorpp::CountAccesses> > accessor(
+			&AtomicValue::get, &value, &AtomicValue::set, &value
+		);
+		runReadWriteMatrix("contention", "same accessor count accesses",
+			[&accessor](int) { return accessor.get(); },
+			[&accessor](int, const uint64_t i) { accessor.set((int)i); }
+		);
+	}
+	{
+		AtomicValue value;
+		accessorpp::Accessor<int, InstrumentedPolicies<accessorpp::CountAccessesPerThread> > accessor(
+			&AtomicValue::get, &value, &AtomicValue::set, &value
+		);
+		runReadWriteMatrix("contention", "same accessor count accesses per thread",
+			[&accessor](int) { return accessor.get(); },
+			[&accessor](int, const uint64_t i) { accessor.set((int)i); }
+		);
+	}
+}
+
+TEST_CASE("b3, contention, adjacent accessors")
+{
+	// Each thread writes its own accessor. The values of the adjacent accessors are packed
+	// in one array, so they share cache lines. The padded values don't.
+	const int maxThreadCount = getThreadCountList().back();
+	std::unique_ptr<AtomicValue[]> adjacentValueList(new AtomicValue[maxThreadCount]);
+	std::unique_ptr<PaddedValue[]> paddedValueList(new PaddedValue[maxThreadCount]);
+	std::vector<accessorpp::Accessor<int, ExternalPolicies> > adjacentList;
+	std::vector<accessorpp::Accessor<int, ExternalPolicies> > paddedList;
+	adjacentList.reserve(maxThreadCount);
+	paddedList.reserve(maxThreadCount);
+	for(int i = 0; i < maxThreadCount; ++i) {
+		AtomicValue * adjacentValue = &adjacentValueList[i];
+		adjacentList.emplace_back(&AtomicValue::get, adjacentValue, &AtomicValue::set, adjacentValue);
+		AtomicValue * paddedValue = &paddedValueList[i].value;
+		paddedList.emplace_back(&AtomicValue::get, paddedValue, &AtomicValue::set, paddedValue);
+	}
+	for(const int threadCount : getThreadCountList()) {
+		runContention("contention", "adjacent accessors", 0, threadCount,
+			[](int) { return 0; },
+			[&adjacentList](const int threadIndex, const uint64_t i) { adjacentList[threadIndex].set((int)i); }
+		);
+		runContention("contention", "padded accessors", 0, threadCount,
+			[](int) { return 0; },
+			[&paddedList](const int threadIndex, const uint64_t i) { paddedList[threadIndex].set((int)i); }
+		);
+	}
+}
+
+TEST_CASE("b3, contention, callback dispatch")
+{
+	AtomicValue value;
+	std::atomic<uint64_t> callbackCount(0);
+	accessorpp::Accessor<int, ConcurrentCallbackPolicies> accessor(&AtomicValue::get, &value, &AtomicValue::set, &value);
+	accessor.onChanged().append([&callbackCount](int) {
+		callbackCount.fetch_add(1, std::memory_order_relaxed);
+	});
+	runReadWriteMatrix("contention", "concurrent callback list",
+		[&accessor](int) { return accessor.get(); },
+		[&accessor](int, const uint64_t i) { accessor.set((int)i); }
+	);
+	REQUIRE(callbackCount.load() > 0);
+}
+
+TEST_CASE("b3, contention, thread safe storages")
+{
+	{
+		AtomicValue value;
+		accessorpp::Accessor<int, ThreadCachedPolicies> accessor(
+			[&value]() { return value.get(); },
+			[&value](const int newValue) { value.set(newValue); }
+		);
+		runReadWriteMatrix("contention", "thread cached",
+			[&accessor](int) { return accessor.get(); },
+			[&accessor](int, const uint64_t i) { accessor.set((int)i); }
+		);
+	}
+	{
+		accessorpp::Accessor<int, TransactionalPolicies> accessor(0);
+		runReadWriteMatrix("contention", "transactional",
+			[&accessor](int) { return accessor.get(); },
+			[&accessor](int, const uint64_t i) { accessor.set((int)i); }
+		);
+	}
+	{
+		accessorpp::VersionedObject object;
+		accessorpp::Accessor<int, VersionedPolicies> accessor(object, 0);
+		runReadWriteMatrix("contention", "versioned",
+			[&accessor](int) { return accessor.get(); },
+			[&accessor](int, const uint64_t i) { accessor.set((int)i); }
+		);
+	}
+}
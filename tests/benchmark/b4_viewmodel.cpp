@@ -0,0 +1,268 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Bind N models to M views each, the same as tutorial_view_model_binding.cpp,
+// then drive user input and model update storms through the bindings.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+class CallbackList
+{
+public:
+	using Callback = std::function<void(const std::string &, void *)>;
+
+	void append(const Callback& callback) {
+		callbackList.push_back(callback);
+	}
+
+	void operator () (const std::string & text, void * data) {
+		for(auto& callback : callbackList) {
+			callback(text, data);
+		}
+	}
+
+private:
+	std::vector<Callback> callbackList;
+};
+
+// Same as CallbackList, but without the callback data.
+class PlainCallbackList
+{
+public:
+	using Callback = std::function<void(const std::string &)>;
+
+	void append(const Callback& callback) {
+		callbackList.push_back(callback);
+	}
+
+	void operator () (const std::string & text) {
+		for(auto& callback : callbackList) {
+			callback(text);
+		}
+	}
+
+private:
+	std::vector<Callback> callbackList;
+};
+
+struct CallbackDataPolicies
+{
+	using OnChangedCallback = CallbackList;
+	using CallbackData = void *;
+};
+
+struct PlainPolicies
+{
+	using OnChangedCallback = PlainCallbackList;
+};
+
+struct Model
+{
+	accessorpp::Accessor<std::string, CallbackDataPolicies> text;
+};
+
+struct PlainModel
+{
+	accessorpp::Accessor<std::string, PlainPolicies> text;
+};
+
+class EditView
+{
+public:
+	explicit EditView(Model * modelToBind) : model(modelToBind), displayedText() {
+		model->text.onChanged().append([this](const std::string & text, void * data) {
+			this->onModelChanged(text, data);
+		});
+	}
+
+	void userInput(const std::string & text) {
+		displayedText = text;
+		model->text.setWithCallbackData(text, (void *)this);
+	}
+
+	const std::string & getDisplayedText() const {
+		return displayedText;
+	}
+
+private:
+	void onModelChanged(const std::string & text, void * data) {
+		if(data != this) {
+			displayedText = text;
+		}
+	}
+
+private:
+	Model * model;
+	std::string displayedText;
+};
+
+// The view can't tell its own input from others, so the echo is always applied.
+class PlainEditView
+{
+public:
+	explicit PlainEditView(PlainModel * modelToBind) : model(modelToBind), displayedText() {
+		model->text.onChanged().append([this](const std::string & text) {
+			displayedText = text;
+		});
+	}
+
+	void userInput(const std::string & text) {
+		displayedText = text;
+		model->text.set(text);
+	}
+
+private:
+	PlainModel * model;
+	std::string displayedText;
+};
+
+class LabelView
+{
+public:
+	explicit LabelView(Model * model) : displayedText() {
+		model->text.onChanged().append([this](const std::string & text, void * /*data*/) {
+			this->onModelChanged(text);
+		});
+	}
+
+	explicit LabelView(PlainModel * model) : displayedText() {
+		model->text.onChanged().append([this](const std::string & text) {
+			this->onModelChanged(text);
+		});
+	}
+
+	const std::string & getDisplayedText() const {
+		return displayedText;
+	}
+
+private:
+	void onModelChanged(const std::string & text) {
+		displayedText = "Hello, " + text;
+	}
+
+private:
+	std::string displayedText;
+};
+
+// Each model is bound to one edit view and viewCount - 1 label views.
+template <typename M, typename E>
+struct Binding
+{
+	Binding(const int modelCount, const int viewCount)
+		: modelList(), editViewList(), labelViewList()
+	{
+		for(int i = 0; i < modelCount; ++i) {
+			modelList.emplace_back(new M());
+			editViewList.emplace_back(new E(modelList.back().get()));
+			for(int k = 1; k < viewCount; ++k) {
+				labelViewList.emplace_back(new LabelView(modelList.back().get()));
+			}
+		}
+	}
+
+	std::vector<std::unique_ptr<M> > modelList;
+	std::vector<std::unique_ptr<E> > editViewList;
+	std::vector<std::unique_ptr<LabelView> > labelViewList;
+};
+
+std::vector<std::string> makeTextList()
+{
+	std::vector<std::string> textList;
+	for(int i = 0; i < 16; ++i) {
+		textList.push_back("user typed text " + std::to_string(i * 7919));
+	}
+	return textList;
+}
+
+// Time each operation separately to get the latency distribution of the propagation.
+// The latency includes the overhead of reading the clock twice.
+template <typename F>
+std::vector<std::pair<std::string, double> > measureLatency(F f)
+{
+	using Clock = std::chrono::steady_clock;
+	constexpr int sampleCount = 20000;
+
+	std::vector<double> latencyList;
+	latencyList.reserve(sampleCount);
+	for(int i = 0; i < sampleCount; ++i) {
+		const Clock::time_point start = Clock::now();
+		f((uint64_t)i);
+		latencyList.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+	}
+	std::sort(latencyList.begin(), latencyList.end());
+	return {
+		{ "p50", latencyList[sampleCount / 2] },
+		{ "p99", latencyList[sampleCount * 99 / 100] }
+	};
+}
+
+template <typename F>
+void measureStorm(
+		const std::string & name,
+		const int modelCount,
+		const int viewCount,
+		F f
+	)
+{
+	const std::string configName = name
+		+ " models=" + std::to_string(modelCount)
+		+ " views=" + std::to_string(viewCount);
+	uint64_t iterations = 0;
+	std::vector<std::pair<std::string, double> > metricList = measureLatency(f);
+	const double nsPerOp = measureNanosecondsPerOp(f, &iterations, &metricList);
+	metricList.push_back({ "nsPerListener", nsPerOp / viewCount });
+	BenchmarkReport::getInstance().add({ "view model", configName, "propagate", nsPerOp, iterations, metricList });
+}
+
+} // namespace
+
+TEST_CASE("b4, view model binding")
+{
+	const std::vector<std::string> textList = makeTextList();
+	const int modelCountList[] = { 1, 100, 10000 };
+	const int viewCountList[] = { 1, 4, 16 };
+
+	for(const int modelCount : modelCountList) {
+		for(const int viewCount : viewCountList) {
+			{
+				Binding<Model, EditView> binding(modelCount, viewCount);
+
+				// The user types in the edit view, the edit view ignores the echo.
+				measureStorm("user input", modelCount, viewCount, [&binding, &textList, modelCount](const uint64_t i) {
+					binding.editViewList[i % modelCount]->userInput(textList[i % textList.size()]);
+				});
+
+				// The model is changed by code, all views are updated.
+				measureStorm("model update", modelCount, viewCount, [&binding, &textList, modelCount](const uint64_t i) {
+					binding.modelList[i % modelCount]->text = textList[i % textList.size()];
+				});
+			}
+			{
+				// Same as "user input" but without CallbackData, the difference is the cost of the echo suppression.
+				Binding<PlainModel, PlainEditView> binding(modelCount, viewCount);
+				measureStorm("user input no echo suppression", modelCount, viewCount, [&binding, &textList, modelCount](const uint64_t i) {
+					binding.editViewList[i % modelCount]->userInput(textList[i % textList.size()]);
+				});
+			}
+		}
+	}
+}
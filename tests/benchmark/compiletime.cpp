@@ -0,0 +1,112 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// This file is not linked into any executable. The target "compiletime" compiles it
+// with syntax checking only, to measure the front-end time of instantiating
+// ACCESSORPP_COMPILE_TIME_COUNT distinct accessors.
+// If ACCESSORPP_COMPILE_TIME_CORE is defined, only accessorcore.h is included and
+// the accessors are used without the operators.
+
+#ifdef ACCESSORPP_COMPILE_TIME_CORE
+#include "accessorpp/accessorcore.h"
+#else
+#include "accessorpp/accessor.h"
+#endif
+
+#include <functional>
+
+#ifndef ACCESSORPP_COMPILE_TIME_COUNT
+#define ACCESSORPP_COMPILE_TIME_COUNT 1000
+#endif
+
+namespace {
+
+template <int index>
+struct PlainPolicies
+{
+};
+
+template <int index>
+struct CallbackPolicies
+{
+	using OnChangingCallback = std::function<void (int)>;
+	using OnChangedCallback = std::function<void (int, int)>;
+	using CallbackData = int;
+};
+
+template <int index>
+struct ExternalPolicies
+{
+	using Storage = accessorpp::ExternalStorage;
+	using OnChangedCallback = std::function<void ()>;
+};
+
+template <int index>
+struct SelectPolicies
+{
+	using Type = typename std::conditional<index % 3 == 0,
+		PlainPolicies<index>,
+		typename std::conditional<index % 3 == 1, CallbackPolicies<index>, ExternalPolicies<index> >::type
+	>::type;
+};
+
+int externalValue = 0;
+
+template <int index>
+int useAccessor()
+{
+	using A = accessorpp::Accessor<int, typename SelectPolicies<index>::Type>;
+	A accessor(&externalValue, &externalValue);
+	accessor = index;
+#ifdef ACCESSORPP_COMPILE_TIME_CORE
+	accessor.update([](const int value) { return value + 1; });
+	accessor.setWithCallbackData(accessor.get() * 2, index);
+	return accessor.get();
+#else
+	accessor += 1;
+	accessor.setWithCallbackData(accessor.get() * 2, index);
+	return (accessor == index) ? accessor.get() : (int)(accessor + 1);
+#endif
+}
+
+// Split the range in halves to keep the template recursion depth logarithmic.
+template <int begin, int count>
+struct Instantiate
+{
+	static int run() {
+		return Instantiate<begin, count / 2>::run() + Instantiate<begin + count / 2, count - count / 2>::run();
+	}
+};
+
+template <int begin>
+struct Instantiate <begin, 1>
+{
+	static int run() {
+		return useAccessor<begin>();
+	}
+};
+
+template <int begin>
+struct Instantiate <begin, 0>
+{
+	static int run() {
+		return 0;
+	}
+};
+
+} // namespace
+
+int runCompileTimeBenchmark()
+{
+	return Instantiate<0, ACCESSORPP_COMPILE_TIME_COUNT>::run();
+}
@@ -0,0 +1,387 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Report sizeof and the heap allocations per construction, copy, move and set
+// of each accessor configuration and each Getter/Setter constructor.
+// Usage: memoryreport [--json]
+// The allocations are counted by the replaced global operator new, so this
+// is a separate executable from the benchmark.
+
+#include "accessorpp/accessor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::size_t allocationCount = 0;
+
+} // namespace
+
+// gcc can't see the replaced operator new and operator delete are a pair.
+#if defined(__GNUC__) && ! defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void * operator new(std::size_t size)
+{
+	++allocationCount;
+	void * p = std::malloc(size == 0 ? 1 : size);
+	if(p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void * p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+namespace {
+
+struct ReportItem
+{
+	std::string value;
+	std::string name;
+	std::size_t size;
+	// -1 means the operation is not applicable.
+	long construct;
+	long copy;
+	long move;
+	long set;
+};
+
+std::vector<ReportItem> reportItemList;
+
+template <typename T>
+struct ValueTraits;
+
+template <>
+struct ValueTraits<int>
+{
+	static const char * getName() {
+		return "int";
+	}
+
+	static int make() {
+		return 5;
+	}
+};
+
+template <>
+struct ValueTraits<std::string>
+{
+	static const char * getName() {
+		return "string";
+	}
+
+	// Longer than the small string buffer, so each copy allocates.
+	static std::string make() {
+		return std::string(48, 'a');
+	}
+};
+
+template <typename T>
+struct Holder
+{
+	T getValue() const {
+		return value;
+	}
+
+	void setValue(const T & newValue) {
+		value = newValue;
+	}
+
+	T value;
+};
+
+template <typename T>
+struct GlobalHolder
+{
+	static Holder<T> holder;
+};
+
+template <typename T>
+Holder<T> GlobalHolder<T>::holder {};
+
+template <typename T>
+T freeGet()
+{
+	return GlobalHolder<T>::holder.value;
+}
+
+template <typename T>
+void freeSet(const T & newValue)
+{
+	GlobalHolder<T>::holder.value = newValue;
+}
+
+struct ExternalPolicies
+{
+	using Storage = accessorpp::ExternalStorage;
+};
+
+struct LiteralPolicies
+{
+	using Storage = accessorpp::LiteralStorage;
+};
+
+struct CallbackPolicies
+{
+	using OnChangingCallback = std::function<void ()>;
+	using OnChangedCallback = std::function<void ()>;
+};
+
+template <typename T>
+struct CallbackDataPolicies
+{
+	using OnChangingCallback = std::function<void (const T &, int)>;
+	using OnChangedCallback = std::function<void (const T &, int)>;
+	using CallbackData = int;
+};
+
+struct NoSet
+{
+	template <typename A, typename T>
+	bool operator() (A &, const T &) const {
+		return false;
+	}
+};
+
+struct DefaultSet
+{
+	template <typename A, typename T>
+	bool operator() (A & object, const T & value) const {
+		object.set(value);
+		return true;
+	}
+};
+
+template <typename T>
+struct InstanceSet
+{
+	template <typename A>
+	bool operator() (A & object, const T & value) const {
+		object.set(value, instance);
+		return true;
+	}
+
+	Holder<T> * instance;
+};
+
+// C constructs an object in the buffer using placement new.
+// S sets the value and returns true, or returns false if set is not applicable.
+// The value is prepared before counting.
+template <typename A, typename T, typename C, typename S>
+void measure(const std::string & name, C construct, S set)
+{
+	alignas(A) unsigned char buffer[sizeof(A)];
+	alignas(A) unsigned char copyBuffer[sizeof(A)];
+	alignas(A) unsigned char moveBuffer[sizeof(A)];
+	const T value = ValueTraits<T>::make();
+	ReportItem item { ValueTraits<T>::getName(), name, sizeof(A), 0, 0, 0, -1 };
+
+	std::size_t start = allocationCount;
+	A * object = construct(buffer);
+	item.construct = (long)(allocationCount - start);
+
+	start = allocationCount;
+	A * copied = new (copyBuffer) A(*object);
+	item.copy = (long)(allocationCount - start);
+
+	start = allocationCount;
+	A * moved = new (moveBuffer) A(std::move(*copied));
+	item.move = (long)(allocationCount - start);
+
+	start = allocationCount;
+	if(set(*object, value)) {
+		item.set = (long)(allocationCount - start);
+	}
+
+	moved->~A();
+	copied->~A();
+	object->~A();
+
+	reportItemList.push_back(item);
+}
+
+template <typename T>
+void measureAccessors()
+{
+	static Holder<T> holder {};
+
+	measure<accessorpp::Accessor<T>, T>("Accessor internal", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T>();
+	}, DefaultSet());
+	measure<accessorpp::Accessor<T, LiteralPolicies>, T>("Accessor literal", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T, LiteralPolicies>();
+	}, DefaultSet());
+	measure<accessorpp::Accessor<T, CallbackPolicies>, T>("Accessor internal callbacks", [](void * buffer) {
+		auto accessor = new (buffer) accessorpp::Accessor<T, CallbackPolicies>();
+		accessor->onChanging() = []() {};
+		accessor->onChanged() = []() {};
+		return accessor;
+	}, DefaultSet());
+	measure<accessorpp::Accessor<T, CallbackDataPolicies<T> >, T>("Accessor internal callback data", [](void * buffer) {
+		auto accessor = new (buffer) accessorpp::Accessor<T, CallbackDataPolicies<T> >();
+		accessor->onChanging() = [](const T &, int) {};
+		accessor->onChanged() = [](const T &, int) {};
+		return accessor;
+	}, DefaultSet());
+	measure<accessorpp::Accessor<T, ExternalPolicies>, T>("Accessor external address", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T, ExternalPolicies>(&holder.value, &holder.value);
+	}, DefaultSet());
+	measure<accessorpp::Accessor<T, ExternalPolicies>, T>("Accessor external member bound", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T, ExternalPolicies>(
+			&Holder<T>::value, &holder, &Holder<T>::value, &holder
+		);
+	}, DefaultSet());
+	measure<accessorpp::Accessor<T, ExternalPolicies>, T>("Accessor external member unbound", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T, ExternalPolicies>(&Holder<T>::value, &Holder<T>::value);
+	}, InstanceSet<T> { &holder });
+	measure<accessorpp::Accessor<T, ExternalPolicies>, T>("Accessor external free function", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T, ExternalPolicies>(&freeGet<T>, &freeSet<T>);
+	}, DefaultSet());
+	measure<accessorpp::Accessor<T, ExternalPolicies>, T>("Accessor external member function bound", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T, ExternalPolicies>(
+			&Holder<T>::getValue, &holder, &Holder<T>::setValue, &holder
+		);
+	}, DefaultSet());
+	measure<accessorpp::Accessor<T, ExternalPolicies>, T>("Accessor external member function unbound", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T, ExternalPolicies>(&Holder<T>::getValue, &Holder<T>::setValue);
+	}, InstanceSet<T> { &holder });
+	measure<accessorpp::Accessor<T, ExternalPolicies>, T>("Accessor external lambda", [](void * buffer) {
+		return new (buffer) accessorpp::Accessor<T, ExternalPolicies>(
+			[]() -> T { return holder.value; },
+			[](const T & value) { holder.value = value; }
+		);
+	}, DefaultSet());
+}
+
+template <typename T>
+void measureGetterSetter()
+{
+	static Holder<T> holder {};
+
+	measure<accessorpp::Getter<T>, T>("Getter address", [](void * buffer) {
+		return new (buffer) accessorpp::Getter<T>(&holder.value);
+	}, NoSet());
+	measure<accessorpp::Getter<T>, T>("Getter member bound", [](void * buffer) {
+		return new (buffer) accessorpp::Getter<T>(&Holder<T>::value, &holder);
+	}, NoSet());
+	measure<accessorpp::Getter<T>, T>("Getter member unbound", [](void * buffer) {
+		return new (buffer) accessorpp::Getter<T>(&Holder<T>::value);
+	}, NoSet());
+	measure<accessorpp::Getter<T>, T>("Getter free function", [](void * buffer) {
+		return new (buffer) accessorpp::Getter<T>(&freeGet<T>);
+	}, NoSet());
+	measure<accessorpp::Getter<T>, T>("Getter member function bound", [](void * buffer) {
+		return new (buffer) accessorpp::Getter<T>(&Holder<T>::getValue, &holder);
+	}, NoSet());
+	measure<accessorpp::Getter<T>, T>("Getter member function unbound", [](void * buffer) {
+		return new (buffer) accessorpp::Getter<T>(&Holder<T>::getValue);
+	}, NoSet());
+	measure<accessorpp::Getter<T>, T>("Getter lambda", [](void * buffer) {
+		return new (buffer) accessorpp::Getter<T>([]() -> T { return holder.value; });
+	}, NoSet());
+
+	measure<accessorpp::Setter<T>, T>("Setter address", [](void * buffer) {
+		return new (buffer) accessorpp::Setter<T>(&holder.value);
+	}, NoSet());
+	measure<accessorpp::Setter<T>, T>("Setter member bound", [](void * buffer) {
+		return new (buffer) accessorpp::Setter<T>(&Holder<T>::value, &holder);
+	}, NoSet());
+	measure<accessorpp::Setter<T>, T>("Setter member unbound", [](void * buffer) {
+		return new (buffer) accessorpp::Setter<T>(&Holder<T>::value);
+	}, NoSet());
+	measure<accessorpp::Setter<T>, T>("Setter free function", [](void * buffer) {
+		return new (buffer) accessorpp::Setter<T>(&freeSet<T>);
+	}, NoSet());
+	measure<accessorpp::Setter<T>, T>("Setter member function bound", [](void * buffer) {
+		return new (buffer) accessorpp::Setter<T>(&Holder<T>::setValue, &holder);
+	}, NoSet());
+	measure<accessorpp::Setter<T>, T>("Setter member function unbound", [](void * buffer) {
+		return new (buffer) accessorpp::Setter<T>(&Holder<T>::setValue);
+	}, NoSet());
+	measure<accessorpp::Setter<T>, T>("Setter lambda", [](void * buffer) {
+		return new (buffer) accessorpp::Setter<T>([](const T & value) { holder.value = value; });
+	}, NoSet());
+}
+
+void printCount(const long count)
+{
+	if(count < 0) {
+		std::printf("%7s", "-");
+	}
+	else {
+		std::printf("%7ld", count);
+	}
+}
+
+void printTable()
+{
+	std::printf("%-8s %-42s %6s %7s %7s %7s %7s\n", "value", "configuration", "sizeof", "ctor", "copy", "move", "set");
+	for(const ReportItem & item : reportItemList) {
+		std::printf("%-8s %-42s %6zu", item.value.c_str(), item.name.c_str(), item.size);
+		printCount(item.construct);
+		printCount(item.copy);
+		printCount(item.move);
+		printCount(item.set);
+		std::printf("\n");
+	}
+}
+
+void printJson()
+{
+	std::printf("{\n\t\"unit\": \"allocations\",\n\t\"results\": [\n");
+	for(std::size_t i = 0; i < reportItemList.size(); ++i) {
+		const ReportItem & item = reportItemList[i];
+		std::printf(
+			"\t\t{ \"value\": \"%s\", \"name\": \"%s\", \"sizeof\": %zu, \"construct\": %ld, \"copy\": %ld, \"move\": %ld, \"set\": %ld }%s\n",
+			item.value.c_str(), item.name.c_str(), item.size,
+			item.construct, item.copy, item.move, item.set,
+			i + 1 < reportItemList.size() ? "," : ""
+		);
+	}
+	std::printf("\t]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+	measureAccessors<int>();
+	measureAccessors<std::string>();
+	measureGetterSetter<int>();
+
+	if(argc > 1 && std::strcmp(argv[1], "--json") == 0) {
+		printJson();
+	}
+	else {
+		printTable();
+	}
+
+	return 0;
+}
@@ -0,0 +1,165 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+// Hardware performance counters of the calling thread, via Linux perf_event_open.
+// They are collected only if environment variable ACCESSORPP_BENCHMARK_PERF is set to 1.
+// There is no generic event for indirect branch mispredicts, set ACCESSORPP_BENCHMARK_PERF_INDIRECT
+// to the raw event code of the CPU (see "perf list --details") to collect it.
+// The counters which can't be opened are listed in the status instead of failing the benchmark.
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+class PerfCounters
+{
+private:
+	struct Counter
+	{
+		std::string name;
+		int fd;
+	};
+
+public:
+	static PerfCounters & getInstance() {
+		static PerfCounters perfCounters;
+		return perfCounters;
+	}
+
+	bool isEnabled() const {
+		return ! counterList.empty();
+	}
+
+	// Such as "disabled", "enabled", or "enabled, unavailable: llcMisses (Permission denied)".
+	const std::string & getStatus() const {
+		return status;
+	}
+
+	void start() {
+#if defined(__linux__)
+		for(const Counter & counter : counterList) {
+			ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	// Stop counting and return the counts per operation.
+	std::vector<std::pair<std::string, double> > stop(const uint64_t operationCount) {
+		std::vector<std::pair<std::string, double> > result;
+#if defined(__linux__)
+		for(const Counter & counter : counterList) {
+			ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+		}
+		for(const Counter & counter : counterList) {
+			// value, time enabled, time running. The value is scaled if the counter was multiplexed.
+			uint64_t data[3] = {};
+			if(read(counter.fd, data, sizeof(data)) != (ssize_t)sizeof(data) || data[2] == 0) {
+				continue;
+			}
+			const double value = (double)data[0] * (double)data[1] / (double)data[2];
+			result.push_back({ counter.name, value / (double)operationCount });
+		}
+#else
+		(void)operationCount;
+#endif
+		return result;
+	}
+
+private:
+	PerfCounters() : counterList(), status("disabled") {
+		const char * enabled = std::getenv("ACCESSORPP_BENCHMARK_PERF");
+		if(enabled == nullptr || std::strcmp(enabled, "1") != 0) {
+			return;
+		}
+
+#if defined(__linux__)
+		std::string unavailable;
+		const auto open = [this, &unavailable](const char * name, const uint32_t type, const uint64_t config) {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			const int fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+			if(fd < 0) {
+				unavailable += std::string(unavailable.empty() ? "" : ", ") + name + " (" + std::strerror(errno) + ")";
+				return;
+			}
+			counterList.push_back({ name, fd });
+		};
+
+		open("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		open("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		open("branchMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+		open("l1dMisses", PERF_TYPE_HW_CACHE,
+			PERF_COUNT_HW_CACHE_L1D
+			| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+			| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+		);
+		open("llcMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+		const char * indirect = std::getenv("ACCESSORPP_BENCHMARK_PERF_INDIRECT");
+		if(indirect != nullptr && *indirect != 0) {
+			open("indirectBranchMisses", PERF_TYPE_RAW, std::strtoull(indirect, nullptr, 0));
+		}
+		else {
+			unavailable += std::string(unavailable.empty() ? "" : ", ") + "indirectBranchMisses (ACCESSORPP_BENCHMARK_PERF_INDIRECT is not set)";
+		}
+
+		if(counterList.empty()) {
+			status = "unavailable: " + unavailable;
+		}
+		else if(! unavailable.empty()) {
+			status = "enabled, unavailable: " + unavailable;
+		}
+		else {
+			status = "enabled";
+		}
+#else
+		status = "unavailable: perf_event_open is only supported on Linux";
+#endif
+	}
+
+	~PerfCounters() {
+#if defined(__linux__)
+		for(const Counter & counter : counterList) {
+			close(counter.fd);
+		}
+#endif
+	}
+
+private:
+	std::vector<Counter> counterList;
+	std::string status;
+};
+
+#endif
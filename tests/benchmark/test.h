@@ -15,9 +15,17 @@
 #define TEST_H
 
 #include "../catch.hpp"
+#include "perfcounters.h"
 
 #include <chrono>
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
 
 template <typename F>
 uint64_t measureElapsedTime(F f)
@@ -34,6 +42,183 @@ uint64_t measureElapsedTime(F f)
 #define NON_INLINE __attribute__((noinline))
 #endif
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+inline NON_INLINE void useBenchmarkPointer(const volatile void *)
+{
+}
+
+// Prevent the compiler from removing the computation of value.
+template <typename T>
+inline void doNotOptimize(const T & value)
+{
+	useBenchmarkPointer(&value);
+	_ReadWriteBarrier();
+}
+
+// Prevent the compiler from removing or reordering the memory writes.
+inline void clobberMemory()
+{
+	_ReadWriteBarrier();
+}
+#else
+template <typename T>
+inline void doNotOptimize(const T & value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory()
+{
+	asm volatile("" : : : "memory");
+}
+#endif
+
+struct BenchmarkResult
+{
+	std::string group;
+	std::string name;
+	std::string operation;
+	double nsPerOp;
+	uint64_t iterations;
+	// Additional named values, such as the throughput and latency percentiles.
+	std::vector<std::pair<std::string, double> > metricList;
+};
+
+// The results are written to the JSON file when the program exits.
+// The file name is in environment variable ACCESSORPP_BENCHMARK_JSON, default is benchmark_result.json.
+class BenchmarkReport
+{
+public:
+	static BenchmarkReport & getInstance() {
+		static BenchmarkReport report;
+		return report;
+	}
+
+	void add(const BenchmarkResult & result) {
+		resultList.push_back(result);
+		std::cout << result.group << " " << result.name << " " << result.operation
+			<< ": " << result.nsPerOp << " ns/op";
+		for(const auto & metric : result.metricList) {
+			std::cout << " " << metric.first << " = " << metric.second;
+		}
+		std::cout << std::endl;
+	}
+
+private:
+	BenchmarkReport() : resultList() {
+		std::cout << "Performance counters: " << PerfCounters::getInstance().getStatus() << std::endl;
+	}
+
+	~BenchmarkReport() {
+		if(resultList.empty()) {
+			return;
+		}
+		const char * fileName = std::getenv("ACCESSORPP_BENCHMARK_JSON");
+		std::ofstream file(fileName != nullptr ? fileName : "benchmark_result.json");
+		file << "{\n\t\"unit\": \"ns/op\",\n";
+		file << "\t\"perfCounters\": ";
+		writeJsonString(file, PerfCounters::getInstance().getStatus());
+		file << ",\n";
+		file << "\t\"results\": [\n";
+		for(std::size_t i = 0; i < resultList.size(); ++i) {
+			const BenchmarkResult & result = resultList[i];
+			file << "\t\t{ \"group\": ";
+			writeJsonString(file, result.group);
+			file << ", \"name\": ";
+			writeJsonString(file, result.name);
+			file << ", \"operation\": ";
+			writeJsonString(file, result.operation);
+			file << ", \"nsPerOp\": " << result.nsPerOp
+				<< ", \"iterations\": " << result.iterations;
+			for(const auto & metric : result.metricList) {
+				file << ", ";
+				writeJsonString(file, metric.first);
+				file << ": " << metric.second;
+			}
+			file << " }" << (i + 1 < resultList.size() ? "," : "") << "\n";
+		}
+		file << "\t]\n}\n";
+	}
+
+	// The names may contain quotes, backslashes or control characters, such as a perf counters
+	// status with the error message from the system.
+	static void writeJsonString(std::ostream & stream, const std::string & text) {
+		stream << '"';
+		for(const char ch : text) {
+			const unsigned char c = (unsigned char)ch;
+			if(c == '"' || c == '\\') {
+				stream << '\\' << ch;
+			}
+			else if(c < 0x20) {
+				char escaped[8];
+				std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)c);
+				stream << escaped;
+			}
+			else {
+				stream << ch;
+			}
+		}
+		stream << '"';
+	}
+
+private:
+	std::vector<BenchmarkResult> resultList;
+};
+
+// Invoke f(i) for i in [0, iterations), the iterations is calibrated so each run takes about 20 ms.
+// Returns the ns/op of the fastest of several runs, and the iterations of each run.
+// If the performance counters are enabled, one more run is counted and the counts
+// per operation are appended to outMetricList.
+template <typename F>
+double measureNanosecondsPerOp(
+		F f,
+		uint64_t * outIterations = nullptr,
+		std::vector<std::pair<std::string, double> > * outMetricList = nullptr
+	)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto run = [&f](const uint64_t iterations) -> double {
+		const Clock::time_point start = Clock::now();
+		for(uint64_t i = 0; i < iterations; ++i) {
+			f(i);
+		}
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+	};
+
+	uint64_t iterations = 1000;
+	while(run(iterations) < 20 * 1000 * 1000 && iterations < (uint64_t(1) << 32)) {
+		iterations *= 2;
+	}
+	double best = run(iterations);
+	for(int i = 0; i < 4; ++i) {
+		const double elapsed = run(iterations);
+		if(elapsed < best) {
+			best = elapsed;
+		}
+	}
+	if(outIterations != nullptr) {
+		*outIterations = iterations;
+	}
+	if(outMetricList != nullptr && PerfCounters::getInstance().isEnabled()) {
+		PerfCounters::getInstance().start();
+		run(iterations);
+		const std::vector<std::pair<std::string, double> > counterList = PerfCounters::getInstance().stop(iterations);
+		outMetricList->insert(outMetricList->end(), counterList.begin(), counterList.end());
+	}
+	return best / (double)iterations;
+}
+
+template <typename F>
+void measureNanoseconds(const std::string & group, const std::string & name, const std::string & operation, F f)
+{
+	uint64_t iterations = 0;
+	std::vector<std::pair<std::string, double> > metricList;
+	const double nsPerOp = measureNanosecondsPerOp(f, &iterations, &metricList);
+	BenchmarkReport::getInstance().add({ group, name, operation, nsPerOp, iterations, metricList });
+}
+
 
 
 #endif
@@ -8161,7 +8161,7 @@ namespace Catch {
 
 	// 32kb for the alternate stack seems to be sufficient. However, this value
 	// is experimentally determined, so that's not guaranteed.
-	constexpr static std::size_t sigStackSize = 32768 >= MINSIGSTKSZ ? 32768 : MINSIGSTKSZ;
+	constexpr static std::size_t sigStackSize = 32768;
 
 	static SignalDefs signalDefs[] = {
 		{ SIGINT,  "SIGINT - Terminal interrupt signal" },
@@ -68,7 +68,7 @@ public:
 
 	void userInput(const std::string & text) {
 		displayedText = text;
-		model->text.set(text, (void *)this);
+		model->text.setWithCallbackData(text, (void *)this);
 	}
 
 	const std::string & getDisplayedText() const {
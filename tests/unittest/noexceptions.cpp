@@ -0,0 +1,152 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// This file is compiled with exceptions disabled, see CMakeLists.txt.
+// It must not include catch.hpp.
+
+#include "noexceptions.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/transaction.h"
+#include "accessorpp/versionedobject.h"
+#include "accessorpp/parallelcallbacklist.h"
+#include "accessorpp/executor.h"
+
+#include <atomic>
+
+#ifndef ACCESSORPP_NO_EXCEPTIONS
+#error "ACCESSORPP_NO_EXCEPTIONS should be defined when exceptions are disabled."
+#endif
+
+namespace {
+
+std::vector<accessorpp::ErrorCode> errorList;
+
+struct RecordError
+{
+	static void onError(const accessorpp::ErrorCode code) {
+		errorList.push_back(code);
+	}
+};
+
+struct RecordErrorPolicies
+{
+	using ErrorHandler = RecordError;
+};
+
+struct IgnoreErrorPolicies
+{
+	using ErrorHandler = accessorpp::IgnoreError;
+};
+
+struct TransactionalPolicies
+{
+	using Storage = accessorpp::TransactionalStorage;
+	using ErrorHandler = accessorpp::IgnoreError;
+};
+
+struct VersionedPolicies
+{
+	using Storage = accessorpp::VersionedStorage;
+	using ErrorHandler = accessorpp::IgnoreError;
+};
+
+} // namespace
+
+NoExceptionsResult runNoExceptions()
+{
+	NoExceptionsResult result;
+	errorList.clear();
+
+	int value = 1;
+	auto readOnly = accessorpp::createReadOnlyAccessor<int>(
+		[&value]() { return value; },
+		RecordErrorPolicies()
+	);
+	readOnly = 5;
+	readOnly.update([](const int oldValue) { return oldValue + 1; });
+	result.readOnlyValue = readOnly.get();
+
+	accessorpp::Accessor<int, RecordErrorPolicies> noGetter;
+	noGetter.setGetter(accessorpp::Getter<int, RecordErrorPolicies>());
+	result.emptyGetterValue = noGetter.get();
+
+	// An empty getter function is the same as no getter, it doesn't call std::function which would abort.
+	accessorpp::Getter<int, RecordErrorPolicies> emptyGetter(std::function<int ()>{});
+	result.emptyCallableGetterValue = emptyGetter.get();
+
+	// An empty setter function is a no-op instead of calling std::function which would abort.
+	int setterValue = 0;
+	accessorpp::Setter<int> emptySetter(std::function<void (int)>{});
+	emptySetter = 3;
+	accessorpp::Setter<int> movedSetter(&setterValue);
+	accessorpp::Setter<int> setter(std::move(movedSetter));
+	movedSetter = 4;
+	setter = 5;
+	result.emptySetterValue = setterValue;
+
+	auto ignored = accessorpp::createReadOnlyAccessor<int>(
+		[&value]() { return value; },
+		IgnoreErrorPolicies()
+	);
+	result.trySetResult = ignored.trySet(3);
+	ignored = 3;
+
+	// Don't use DefaultPolicies here, its ThrowOnError can't be compiled without exceptions.
+	accessorpp::Accessor<int, IgnoreErrorPolicies> writable;
+	result.trySetWritableResult = writable.trySet(8);
+	result.writableValue = writable.get();
+
+	// The other test files use the same templates with CaptureExceptions, the exception policy
+	// is a template parameter so both are linked into the program without conflict.
+	accessorpp::Accessor<int, TransactionalPolicies> bid(1);
+	accessorpp::Accessor<int, TransactionalPolicies> ask(2);
+	accessorpp::transact<accessorpp::NoExceptions>([&bid, &ask](accessorpp::Transaction & tx) {
+		tx.set(bid, tx.get(ask) + 1);
+	});
+	result.transactionValue = bid.get();
+
+	accessorpp::VersionedObject object;
+	accessorpp::Accessor<int, VersionedPolicies> width(object, 1);
+	object.batch([&width]() {
+		width = 4;
+	});
+	result.batchValue = object.snapshot().get(width);
+
+	accessorpp::ThreadPool threadPool(2);
+	std::atomic<int> sum(0);
+	accessorpp::ParallelCallbackList<void (int), accessorpp::NoExceptions> callbackList;
+	callbackList.setThreadPool(&threadPool);
+	callbackList.setParallelThreshold(2);
+	callbackList.setChunkSize(1);
+	for(int i = 0; i < 4; ++i) {
+		callbackList.append([&sum](const int value) {
+			sum += value;
+		});
+	}
+	callbackList(1);
+	callbackList.setDispatch(accessorpp::ParallelDispatch::async);
+	callbackList(2);
+	callbackList.waitForIdle();
+	result.parallelSum = sum;
+
+	accessorpp::ExecutorCallback<std::function<void (int)>, accessorpp::NoExceptions> executorCallback;
+	executorCallback = [&result](const int value) {
+		result.executorValue = value;
+	};
+	executorCallback.setExecutor(threadPool);
+	executorCallback(6);
+	executorCallback.waitForIdle();
+
+	result.errorList = errorList;
+	return result;
+}
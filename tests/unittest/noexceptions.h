@@ -0,0 +1,40 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NOEXCEPTIONS_H
+#define NOEXCEPTIONS_H
+
+#include "accessorpp/error.h"
+
+#include <vector>
+
+struct NoExceptionsResult
+{
+	int readOnlyValue;
+	int emptyGetterValue;
+	int emptyCallableGetterValue;
+	int emptySetterValue;
+	accessorpp::ErrorCode trySetResult;
+	accessorpp::ErrorCode trySetWritableResult;
+	int writableValue;
+	int transactionValue;
+	int batchValue;
+	int parallelSum;
+	int executorValue;
+	std::vector<accessorpp::ErrorCode> errorList;
+};
+
+// Implemented in noexceptions.cpp which is compiled without exceptions.
+NoExceptionsResult runNoExceptions();
+
+#endif
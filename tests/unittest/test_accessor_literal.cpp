@@ -0,0 +1,112 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+struct LiteralPolicies
+{
+	using Storage = accessorpp::LiteralStorage;
+};
+
+using LiteralInt = accessorpp::Accessor<int, LiteralPolicies>;
+
+constexpr LiteralInt literalTable[] = { 1, 2, 3, 5, 8 };
+
+// Constant initialized, there is no dynamic initializer for it.
+LiteralInt mutableLiteralTable[] = { 13, 21 };
+
+static_assert(std::is_trivially_destructible<LiteralInt>::value, "");
+static_assert(sizeof(LiteralInt) == sizeof(int), "");
+static_assert(literalTable[3].get() == 5, "");
+static_assert(literalTable[4] == 8, "");
+static_assert(literalTable[0] < literalTable[1], "");
+static_assert((literalTable[1] + literalTable[2] * 2).get() == 8, "");
+static_assert((-literalTable[0]).get() == -1, "");
+static_assert(literalTable[2] + 1 == 4, "");
+
+#ifdef ACCESSORPP_SUPPORT_STANDARD_17
+constexpr int calculate()
+{
+	LiteralInt accessor(3);
+	accessor = 5;
+	accessor += 2;
+	accessor *= literalTable[1];
+	++accessor;
+	accessor--;
+	accessor.update([](const int value) { return value - 4; });
+	return accessor.get();
+}
+
+static_assert(calculate() == 10, "");
+#endif
+
+} // namespace
+
+TEST_CASE("Accessor, LiteralStorage, runtime")
+{
+	LiteralInt accessor;
+	REQUIRE(accessor.get() == 0);
+	REQUIRE(accessor.isDirectAccess());
+	REQUIRE(! accessor.isReadOnly());
+	REQUIRE(LiteralInt::literalStorage);
+	REQUIRE(! LiteralInt::internalStorage);
+
+	accessor = 5;
+	REQUIRE(accessor == 5);
+	accessor += 3;
+	REQUIRE(accessor.directGet() == 8);
+	REQUIRE(accessor.trySet(9) == accessorpp::ErrorCode::ok);
+	REQUIRE(accessor == 9);
+
+	REQUIRE(mutableLiteralTable[1] == 21);
+	mutableLiteralTable[1] = 34;
+	REQUIRE(mutableLiteralTable[1] == 34);
+
+	LiteralInt copied(literalTable[2]);
+	REQUIRE(copied == 3);
+	copied = literalTable[4];
+	REQUIRE(copied == 8);
+}
+
+TEST_CASE("Accessor, LiteralStorage, callbacks")
+{
+	struct Policies
+	{
+		using Storage = accessorpp::LiteralStorage;
+		using OnChangingCallback = std::function<void (int)>;
+		using OnChangedCallback = std::function<void (int)>;
+	};
+
+	accessorpp::Accessor<int, Policies> accessor(1);
+	std::vector<int> changingList;
+	std::vector<int> changedList;
+	accessor.onChanging() = [&changingList, &accessor](const int value) {
+		changingList.push_back(value);
+		changingList.push_back(accessor.get());
+	};
+	accessor.onChanged() = [&changedList, &accessor](const int value) {
+		changedList.push_back(value);
+		changedList.push_back(accessor.get());
+	};
+
+	accessor = 2;
+	accessor += 3;
+	REQUIRE(changingList == std::vector<int> { 2, 1, 5, 2 });
+	REQUIRE(changedList == std::vector<int> { 2, 2, 5, 5 });
+}
@@ -81,3 +81,100 @@ TEST_CASE("Accessor, int, binary operator +, -, *, /, %, &, |, ^, <<, >>")
 	REQUIRE((accessor1 >> 2).get() == 3);
 }
 
+
+TEST_CASE("Accessor, binary operators are lazy expressions")
+{
+	int getterCount = 0;
+	int value = 5;
+	accessorpp::Accessor<int, accessorpp::DefaultPolicies> external(
+		[&value, &getterCount]() {
+			++getterCount;
+			return value;
+		},
+		accessorpp::noSetter
+	);
+	accessorpp::Accessor<int> accessor1(2);
+	accessorpp::Accessor<int> accessor2(3);
+
+	auto expression = external + accessor1 * accessor2 - 1;
+	REQUIRE(getterCount == 0);
+	REQUIRE(expression.get() == 10);
+	REQUIRE(getterCount == 1);
+
+	// Evaluated again with the current values.
+	value = 7;
+	accessor1 = 4;
+	REQUIRE(expression == 18);
+	REQUIRE(getterCount == 2);
+
+	accessor1 = external + accessor2;
+	REQUIRE(accessor1 == 10);
+
+	REQUIRE(-(accessor1 + accessor2) == -13);
+	REQUIRE((accessor1 + (accessor2 * 2)).get() == 16);
+}
+
+TEST_CASE("Accessor, initialized from an expression")
+{
+	accessorpp::Accessor<int> accessor1(2);
+	accessorpp::Accessor<int> accessor2(3);
+
+	accessorpp::Accessor<int> sum = accessor1 + accessor2;
+	accessorpp::Accessor<int> negative = -accessor1;
+	accessorpp::Accessor<long long> product(accessor1 * accessor2);
+	REQUIRE(sum == 5);
+	REQUIRE(negative == -2);
+	REQUIRE(product == 6);
+
+	// The new accessor holds the value, it doesn't follow the sources.
+	accessor1 = 10;
+	REQUIRE(sum == 5);
+
+	accessorpp::Accessor<std::string> text1("abc");
+	accessorpp::Accessor<std::string> text2 = text1 + "def";
+	REQUIRE(text2 == "abcdef");
+}
+
+TEST_CASE("Accessor, expression held by auto, named and temporary accessors")
+{
+	accessorpp::Accessor<std::string> text("abc");
+
+	// A named accessor is referred to, the expression sees the later writes.
+	auto expression = text + "!";
+	text = "def";
+	REQUIRE(expression.get() == "def!");
+
+	// Converting the expression reads the accessor immediately.
+	const std::string value = text + "!";
+	text = "xyz";
+	REQUIRE(value == "def!");
+
+	// A temporary accessor is read when the expression is created, the expression
+	// doesn't refer to it after it's destroyed.
+	const auto makeText = [](const std::string & s) {
+		return accessorpp::Accessor<std::string>(s);
+	};
+	auto fromTemporary = makeText("uvw") + "!";
+	REQUIRE(fromTemporary.get() == "uvw!");
+	auto withTemporary = text + makeText("uvw");
+	text = "abc";
+	REQUIRE(withTemporary.get() == "abcuvw");
+
+	const auto makeNumber = [](const int n) {
+		return accessorpp::Accessor<int>(n);
+	};
+	auto negative = -makeNumber(3);
+	REQUIRE(negative.get() == -3);
+	auto nested = (makeNumber(2) + makeNumber(3)) * makeNumber(4);
+	REQUIRE(nested.get() == 20);
+}
+
+TEST_CASE("Accessor, std::string, binary operator +")
+{
+	accessorpp::Accessor<std::string> accessor1("abc");
+	accessorpp::Accessor<std::string> accessor2("def");
+
+	REQUIRE((accessor1 + accessor2).get() == "abcdef");
+	REQUIRE(accessor1 + "xyz" == "abcxyz");
+	REQUIRE(accessor1 + accessor2 + "!" == std::string("abcdef!"));
+}
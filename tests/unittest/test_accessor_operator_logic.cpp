@@ -58,3 +58,78 @@ TEST_CASE("Accessor, logic operator &&, ||")
 	REQUIRE((accessor1 && accessor2));
 
 }
+
+namespace {
+
+struct CopyCounter
+{
+	CopyCounter(const int value = 0) : value(value) {
+	}
+
+	CopyCounter(const CopyCounter & other) : value(other.value) {
+		++copyCount;
+	}
+
+	CopyCounter & operator = (const CopyCounter & other) {
+		value = other.value;
+		++copyCount;
+		return *this;
+	}
+
+	bool operator == (const CopyCounter & other) const {
+		return value == other.value;
+	}
+
+	bool operator < (const CopyCounter & other) const {
+		return value < other.value;
+	}
+
+	bool operator == (const int other) const {
+		return value == other;
+	}
+
+	int value;
+	static int copyCount;
+};
+
+int CopyCounter::copyCount = 0;
+
+std::ostream & operator << (std::ostream & stream, const CopyCounter & value)
+{
+	stream << value.value;
+	return stream;
+}
+
+} // namespace
+
+TEST_CASE("Accessor, logic operators compare internal storage by reference")
+{
+	accessorpp::Accessor<CopyCounter> accessor1(CopyCounter(1));
+	accessorpp::Accessor<CopyCounter> accessor2(CopyCounter(2));
+	const CopyCounter value(1);
+
+	CopyCounter::copyCount = 0;
+	REQUIRE(accessor1 == value);
+	REQUIRE(accessor1 < accessor2);
+	REQUIRE(! (accessor2 < accessor1));
+	// Heterogeneous compare
+	REQUIRE(accessor1 == 1);
+	REQUIRE(CopyCounter::copyCount == 0);
+
+	// The replaced getter is respected.
+	accessor1.setGetter([]() {
+		return CopyCounter(3);
+	});
+	REQUIRE(accessor1 == 3);
+	REQUIRE(accessor2 < accessor1);
+}
+
+TEST_CASE("Accessor, std::string, logic operators with const char *")
+{
+	accessorpp::Accessor<std::string> accessor("abc");
+	const char * text = "abd";
+	REQUIRE(accessor == "abc");
+	REQUIRE(accessor != text);
+	REQUIRE(accessor < text);
+	REQUIRE(accessor == std::string("abc"));
+}
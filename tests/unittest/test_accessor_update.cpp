@@ -0,0 +1,143 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/transaction.h"
+#include "accessorpp/versionedobject.h"
+
+#include <vector>
+#include <thread>
+
+TEST_CASE("Accessor, update, internal storage")
+{
+	struct Policies
+	{
+		using OnChangingCallback = std::function<void (int)>;
+		using OnChangedCallback = std::function<void (int)>;
+	};
+
+	accessorpp::Accessor<int, Policies> accessor(5);
+	std::vector<int> changingList;
+	std::vector<int> changedList;
+	accessor.onChanging() = [&changingList, &accessor](const int value) {
+		changingList.push_back(value);
+		changingList.push_back(accessor.get());
+	};
+	accessor.onChanged() = [&changedList, &accessor](const int value) {
+		changedList.push_back(value);
+		changedList.push_back(accessor.get());
+	};
+
+	accessor.update([](const int value) {
+		return value * 3;
+	});
+	REQUIRE(accessor == 15);
+	REQUIRE(changingList == std::vector<int>{ 15, 5 });
+	REQUIRE(changedList == std::vector<int>{ 15, 15 });
+}
+
+TEST_CASE("Accessor, update, external storage calls getter and setter once")
+{
+	int value = 5;
+	int getterCount = 0;
+	int setterCount = 0;
+	accessorpp::Accessor<int, accessorpp::DefaultPolicies> accessor(
+		[&value, &getterCount]() {
+			++getterCount;
+			return value;
+		},
+		[&value, &setterCount](const int newValue) {
+			++setterCount;
+			value = newValue;
+		}
+	);
+
+	accessor.update([](const int oldValue) {
+		return oldValue + 1;
+	});
+	REQUIRE(value == 6);
+	REQUIRE(getterCount == 1);
+	REQUIRE(setterCount == 1);
+
+	accessor += 2;
+	REQUIRE(value == 8);
+	REQUIRE(getterCount == 2);
+	REQUIRE(setterCount == 2);
+}
+
+TEST_CASE("Accessor, update, replaced setter is respected")
+{
+	accessorpp::Accessor<int> accessor(5);
+	int setterValue = 0;
+	accessor.setSetter([&setterValue](const int value) {
+		setterValue = value;
+	});
+	accessor += 3;
+	REQUIRE(setterValue == 8);
+	REQUIRE(accessor == 5);
+}
+
+TEST_CASE("Accessor, update, read-only")
+{
+	int value = 1;
+	auto accessor = accessorpp::createReadOnlyAccessor<int>([&value]() { return value; });
+	REQUIRE_THROWS(accessor.update([](const int oldValue) { return oldValue + 1; }));
+	REQUIRE(value == 1);
+}
+
+TEST_CASE("Accessor, postfix operators use update")
+{
+	accessorpp::Accessor<int> accessor(5);
+	accessorpp::Accessor<int> result = accessor++;
+	REQUIRE(result == 5);
+	REQUIRE(accessor == 6);
+	result = accessor--;
+	REQUIRE(result == 6);
+	REQUIRE(accessor == 5);
+}
+
+TEST_CASE("Accessor, compound operators are atomic on concurrent storages")
+{
+	constexpr int threadCount = 4;
+	constexpr int addCount = 2000;
+
+	struct TransactionalPolicies
+	{
+		using Storage = accessorpp::TransactionalStorage;
+	};
+	struct VersionedPolicies
+	{
+		using Storage = accessorpp::VersionedStorage;
+	};
+
+	accessorpp::Accessor<int, TransactionalPolicies> transactional(0);
+	accessorpp::VersionedObject object;
+	accessorpp::Accessor<int, VersionedPolicies> versioned(object, 0);
+
+	std::vector<std::thread> threadList;
+	for(int i = 0; i < threadCount; ++i) {
+		threadList.emplace_back([&transactional, &versioned]() {
+			for(int k = 0; k < addCount; ++k) {
+				transactional += 1;
+				++versioned;
+			}
+		});
+	}
+	for(auto & thread : threadList) {
+		thread.join();
+	}
+
+	REQUIRE(transactional == threadCount * addCount);
+	REQUIRE(versioned == threadCount * addCount);
+}
@@ -0,0 +1,180 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/changelog.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+
+namespace {
+
+TEST_CASE("ChangeLog, accessor, every set is recorded in order")
+{
+	struct Policies
+	{
+		using OnChangedCallback = accessorpp::ChangeLogCallback<int>;
+	};
+
+	accessorpp::ChangeLog<int> changeLog(16);
+	REQUIRE(changeLog.getCapacity() == 16);
+
+	accessorpp::Accessor<int, Policies> accessor1;
+	accessorpp::Accessor<int, Policies> accessor2;
+	accessor1.onChanged().attach(changeLog, 1);
+	accessor2.onChanged().attach(changeLog, 2);
+
+	accessor1 = 5;
+	accessor2 = 6;
+	accessor1 = 7;
+
+	std::vector<accessorpp::ChangeRecord<int> > recordList;
+	REQUIRE(changeLog.consume([&recordList](const accessorpp::ChangeRecord<int> & record) {
+		recordList.push_back(record);
+	}) == 3);
+	REQUIRE(recordList.size() == 3);
+	REQUIRE(recordList[0].sequence == 0);
+	REQUIRE(recordList[0].id == 1);
+	REQUIRE(recordList[0].value == 5);
+	REQUIRE(recordList[1].sequence == 1);
+	REQUIRE(recordList[1].id == 2);
+	REQUIRE(recordList[1].value == 6);
+	REQUIRE(recordList[2].sequence == 2);
+	REQUIRE(recordList[2].id == 1);
+	REQUIRE(recordList[2].value == 7);
+
+	REQUIRE(changeLog.consume([](const accessorpp::ChangeRecord<int> &) {}) == 0);
+}
+
+TEST_CASE("ChangeLog, accessor, CallbackData")
+{
+	struct Policies
+	{
+		using OnChangedCallback = accessorpp::ChangeLogCallback<std::string, int>;
+		using CallbackData = int;
+	};
+
+	using ChangeLogType = accessorpp::ChangeLog<std::string, int>;
+	ChangeLogType changeLog(4);
+	accessorpp::Accessor<std::string, Policies> accessor;
+	accessor.onChanged().attach(changeLog, 3);
+
+	accessor = "abc";
+	accessor.setWithCallbackData("def", 9);
+
+	std::vector<ChangeLogType::Record> recordList;
+	changeLog.consume([&recordList](const ChangeLogType::Record & record) {
+		recordList.push_back(record);
+	});
+	REQUIRE(recordList.size() == 2);
+	REQUIRE(recordList[0].value == "abc");
+	REQUIRE(recordList[0].callbackData == 0);
+	REQUIRE(recordList[1].value == "def");
+	REQUIRE(recordList[1].callbackData == 9);
+}
+
+TEST_CASE("ChangeLog, overflow drop")
+{
+	accessorpp::ChangeLog<int> changeLog(4, accessorpp::ChangeLogOverflow::drop);
+	for(int i = 0; i < 6; ++i) {
+		REQUIRE(changeLog.push(0, i) == (i < 4));
+	}
+	REQUIRE(changeLog.getDroppedCount() == 2);
+
+	std::vector<int> valueList;
+	changeLog.consume([&valueList](const accessorpp::ChangeRecord<int> & record) {
+		valueList.push_back(record.value);
+	});
+	REQUIRE(valueList == std::vector<int> { 0, 1, 2, 3 });
+}
+
+TEST_CASE("ChangeLog, overflow overwrite")
+{
+	accessorpp::ChangeLog<int> changeLog(4, accessorpp::ChangeLogOverflow::overwrite);
+	for(int i = 0; i < 6; ++i) {
+		REQUIRE(changeLog.push(0, i));
+	}
+	REQUIRE(changeLog.getDroppedCount() == 2);
+
+	std::vector<accessorpp::ChangeRecord<int> > recordList;
+	changeLog.consume([&recordList](const accessorpp::ChangeRecord<int> & record) {
+		recordList.push_back(record);
+	});
+	REQUIRE(recordList.size() == 4);
+	// The gap in sequence shows the overwritten records.
+	REQUIRE(recordList[0].sequence == 2);
+	REQUIRE(recordList[0].value == 2);
+	REQUIRE(recordList[3].sequence == 5);
+	REQUIRE(recordList[3].value == 5);
+}
+
+TEST_CASE("ChangeLog, consume in bulk")
+{
+	accessorpp::ChangeLog<int> changeLog(8);
+	for(int i = 0; i < 5; ++i) {
+		changeLog.push(0, i);
+	}
+	int sum = 0;
+	REQUIRE(changeLog.consume([&sum](const accessorpp::ChangeRecord<int> & record) { sum += record.value; }, 3) == 3);
+	REQUIRE(sum == 0 + 1 + 2);
+	REQUIRE(changeLog.consume([&sum](const accessorpp::ChangeRecord<int> & record) { sum += record.value; }, 3) == 2);
+	REQUIRE(sum == 0 + 1 + 2 + 3 + 4);
+}
+
+TEST_CASE("ChangeLog, overflow block, multiple producers")
+{
+	constexpr int producerCount = 4;
+	constexpr int pushCount = 10000;
+
+	accessorpp::ChangeLog<int> changeLog(64, accessorpp::ChangeLogOverflow::block);
+
+	std::vector<std::thread> threadList;
+	for(int i = 0; i < producerCount; ++i) {
+		threadList.emplace_back([i, &changeLog]() {
+			for(int k = 0; k < pushCount; ++k) {
+				changeLog.push(i, k);
+			}
+		});
+	}
+
+	std::vector<int> nextValue(producerCount);
+	std::uint64_t nextSequence = 0;
+	bool inOrder = true;
+	int consumedCount = 0;
+	while(consumedCount < producerCount * pushCount) {
+		consumedCount += (int)changeLog.consume([&](const accessorpp::ChangeRecord<int> & record) {
+			inOrder = inOrder
+				&& record.sequence == nextSequence
+				&& record.value == nextValue[record.id]
+			;
+			++nextSequence;
+			++nextValue[record.id];
+		});
+	}
+
+	for(auto & thread : threadList) {
+		thread.join();
+	}
+
+	REQUIRE(inOrder);
+	REQUIRE(changeLog.getDroppedCount() == 0);
+	for(int i = 0; i < producerCount; ++i) {
+		REQUIRE(nextValue[i] == pushCount);
+	}
+}
+
+
+} // namespace
+
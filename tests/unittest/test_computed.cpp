@@ -0,0 +1,190 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/computed.h"
+#include "accessorpp/concurrentcallbacklist.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct SourcePolicies
+{
+	using OnChangedCallback = accessorpp::ConcurrentCallbackList<void (int)>;
+};
+
+struct ComputedPolicies
+{
+	using Storage = accessorpp::ComputedStorage;
+	using ErrorHandler = accessorpp::IgnoreError;
+};
+
+using SourceAccessor = accessorpp::Accessor<int, SourcePolicies>;
+using ComputedAccessor = accessorpp::Accessor<int, ComputedPolicies>;
+
+} // namespace
+
+TEST_CASE("ComputedStorage, computed lazily and cached")
+{
+	SourceAccessor width(3);
+	SourceAccessor height(4);
+	int computeCount = 0;
+	ComputedAccessor area([&width, &height, &computeCount]() {
+		++computeCount;
+		return width * height;
+	}, width, height);
+
+	REQUIRE(area.isReadOnly());
+	REQUIRE(area.isDirty());
+	REQUIRE(computeCount == 0);
+
+	REQUIRE(area.get() == 12);
+	REQUIRE(area == 12);
+	REQUIRE(area.getCached() == 12);
+	REQUIRE(computeCount == 1);
+	REQUIRE(! area.isDirty());
+
+	width = 5;
+	REQUIRE(area.isDirty());
+	REQUIRE(computeCount == 1);
+	height = 6;
+	REQUIRE(area.get() == 30);
+	REQUIRE(area.get() == 30);
+	REQUIRE(computeCount == 2);
+
+	area.invalidate();
+	REQUIRE(area.get() == 30);
+	REQUIRE(computeCount == 3);
+}
+
+TEST_CASE("ComputedStorage, set is rejected")
+{
+	ComputedAccessor computed([]() {
+		return 1;
+	});
+	computed = 5;
+	REQUIRE(computed.trySet(5) == accessorpp::ErrorCode::readOnly);
+	REQUIRE(computed.get() == 1);
+}
+
+TEST_CASE("ComputedStorage, computed sources")
+{
+	SourceAccessor width(2);
+	SourceAccessor height(3);
+	SourceAccessor depth(4);
+	int areaCount = 0;
+	int volumeCount = 0;
+	ComputedAccessor area([&width, &height, &areaCount]() {
+		++areaCount;
+		return width * height;
+	}, width, height);
+	ComputedAccessor volume([&area, &depth, &volumeCount]() {
+		++volumeCount;
+		return area * depth;
+	}, area, depth);
+
+	REQUIRE(volume.get() == 24);
+	REQUIRE(areaCount == 1);
+	REQUIRE(volumeCount == 1);
+
+	// Invalidating area invalidates volume.
+	width = 5;
+	REQUIRE(volume.isDirty());
+	REQUIRE(volume.get() == 60);
+	REQUIRE(areaCount == 2);
+	REQUIRE(volumeCount == 2);
+
+	depth = 1;
+	REQUIRE(! area.isDirty());
+	REQUIRE(volume.get() == 15);
+	REQUIRE(areaCount == 2);
+	REQUIRE(volumeCount == 3);
+
+	// Each time volume reads area, the next change of width invalidates volume again.
+	width = 1;
+	REQUIRE(volume.get() == 3);
+	width = 2;
+	REQUIRE(volume.isDirty());
+	REQUIRE(volume.get() == 6);
+}
+
+TEST_CASE("ComputedStorage, invalidator")
+{
+	int source = 1;
+	int computeCount = 0;
+	ComputedAccessor computed([&source, &computeCount]() {
+		++computeCount;
+		return source * 10;
+	});
+	const accessorpp::ComputedInvalidator invalidator = computed.getInvalidator();
+
+	REQUIRE(computed.get() == 10);
+	source = 2;
+	REQUIRE(computed.get() == 10);
+	invalidator();
+	invalidator(1, std::string("any arguments"));
+	REQUIRE(computed.get() == 20);
+	REQUIRE(computeCount == 2);
+}
+
+TEST_CASE("ComputedStorage, source outlives the computed accessor")
+{
+	SourceAccessor source(1);
+	{
+		ComputedAccessor computed([&source]() {
+			return source + 1;
+		}, source);
+		REQUIRE(computed.get() == 2);
+	}
+	// The invalidator is removed from the callback list.
+	REQUIRE(source.onChanged().empty());
+	source = 2;
+	REQUIRE(source == 2);
+}
+
+TEST_CASE("ComputedStorage, destroying dependents removes the listeners")
+{
+	SourceAccessor source(1);
+	ComputedAccessor plusOne([&source]() {
+		return source + 1;
+	}, source);
+	for(int i = 0; i < 100; ++i) {
+		ComputedAccessor dependent([&source, &plusOne]() {
+			return source + plusOne;
+		}, source, plusOne);
+		REQUIRE(dependent.get() == 3);
+		REQUIRE(source.onChanged().size() == 2);
+	}
+	REQUIRE(source.onChanged().size() == 1);
+	source = 2;
+	REQUIRE(plusOne.get() == 3);
+}
+
+TEST_CASE("ComputedStorage, exception keeps it dirty")
+{
+	bool fail = true;
+	ComputedAccessor computed([&fail]() {
+		if(fail) {
+			throw std::runtime_error("fail");
+		}
+		return 3;
+	});
+	REQUIRE_THROWS(computed.get());
+	REQUIRE(computed.isDirty());
+	fail = false;
+	REQUIRE(computed.get() == 3);
+}
@@ -0,0 +1,144 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/concurrentcallbacklist.h"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+using CallbackListType = accessorpp::ConcurrentCallbackList<void (int)>;
+
+struct Policies
+{
+	using OnChangedCallback = CallbackListType;
+};
+
+TEST_CASE("ConcurrentCallbackList, append and remove")
+{
+	accessorpp::Accessor<int, Policies> accessor;
+	REQUIRE(accessor.onChanged().empty());
+
+	std::vector<int> valueList;
+	auto handle1 = accessor.onChanged().append([&valueList](const int value) {
+		valueList.push_back(value);
+	});
+	auto handle2 = accessor.onChanged().append([&valueList](const int value) {
+		valueList.push_back(value * 10);
+	});
+	REQUIRE(accessor.onChanged().size() == 2);
+
+	accessor = 3;
+	REQUIRE(valueList == std::vector<int> { 3, 30 });
+
+	REQUIRE(accessor.onChanged().remove(handle1));
+	REQUIRE(! accessor.onChanged().remove(handle1));
+	accessor = 5;
+	REQUIRE(valueList == std::vector<int> { 3, 30, 50 });
+
+	REQUIRE(accessor.onChanged().remove(handle2));
+	REQUIRE(accessor.onChanged().empty());
+	accessor = 6;
+	REQUIRE(valueList == std::vector<int> { 3, 30, 50 });
+}
+
+TEST_CASE("ConcurrentCallbackList, remove and append in the callback")
+{
+	CallbackListType callbackList;
+	std::vector<int> valueList;
+	CallbackListType::Handle handle;
+	handle = callbackList.append([&](const int value) {
+		valueList.push_back(value);
+		REQUIRE(callbackList.remove(handle));
+		callbackList.append([&valueList](const int value) {
+			valueList.push_back(value * 10);
+		});
+	});
+
+	// The appended listener is not invoked in current dispatching.
+	callbackList(1);
+	REQUIRE(valueList == std::vector<int> { 1 });
+	callbackList(2);
+	REQUIRE(valueList == std::vector<int> { 1, 20 });
+}
+
+TEST_CASE("ConcurrentCallbackList, retired list is freed when the dispatching finishes")
+{
+	CallbackListType callbackList;
+	std::shared_ptr<int> tracker = std::make_shared<int>(0);
+	const std::weak_ptr<int> trackerObserver(tracker);
+	CallbackListType::Handle trackedHandle = callbackList.append([tracker](int) {});
+	tracker.reset();
+	callbackList.append([&callbackList, &trackedHandle](int) {
+		callbackList.remove(trackedHandle);
+	});
+
+	// The list being dispatched still holds the removed listener, it's freed
+	// by the dispatcher when the dispatching finishes.
+	callbackList(1);
+	REQUIRE(trackerObserver.expired());
+	REQUIRE(callbackList.size() == 1);
+}
+
+TEST_CASE("ConcurrentCallbackList, removed listener is never invoked after remove returns")
+{
+	constexpr int dispatchThreadCount = 3;
+	constexpr int roundCount = 300;
+
+	struct ExternalPolicies
+	{
+		using Storage = accessorpp::ExternalStorage;
+		using OnChangedCallback = CallbackListType;
+	};
+	// The value is not stored, so setting from multiple threads doesn't race on the value.
+	accessorpp::Accessor<int, ExternalPolicies> accessor([]() { return 0; }, [](int) {});
+	std::atomic<bool> stopped(false);
+	std::atomic<int> errorCount(0);
+
+	std::vector<std::thread> threadList;
+	for(int i = 0; i < dispatchThreadCount; ++i) {
+		threadList.emplace_back([&accessor, &stopped]() {
+			int value = 0;
+			while(! stopped.load()) {
+				accessor.set(++value);
+			}
+		});
+	}
+
+	for(int i = 0; i < roundCount; ++i) {
+		std::shared_ptr<std::atomic<bool> > removed = std::make_shared<std::atomic<bool> >(false);
+		auto handle = accessor.onChanged().append([removed, &errorCount](const int) {
+			if(removed->load()) {
+				++errorCount;
+			}
+		});
+		std::this_thread::yield();
+		REQUIRE(accessor.onChanged().remove(handle));
+		removed->store(true);
+	}
+
+	stopped.store(true);
+	for(auto & thread : threadList) {
+		thread.join();
+	}
+	REQUIRE(errorCount == 0);
+	REQUIRE(accessor.onChanged().empty());
+}
+
+
+} // namespace
+
@@ -0,0 +1,133 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/conflation.h"
+
+#include <vector>
+#include <thread>
+#include <memory>
+
+namespace {
+
+struct ConflatedPolicies
+{
+	using OnChangedCallback = accessorpp::ConflatedCallback<int>;
+};
+
+TEST_CASE("Conflation, latest value wins")
+{
+	accessorpp::ConflationSet<int> conflationSet;
+	accessorpp::Accessor<int, ConflatedPolicies> accessor1;
+	accessorpp::Accessor<int, ConflatedPolicies> accessor2;
+	accessor1.onChanged().attach(conflationSet, &accessor1);
+	accessor2.onChanged().attach(conflationSet, &accessor2);
+
+	REQUIRE(conflationSet.empty());
+
+	accessor1 = 1;
+	accessor2 = 2;
+	accessor1 = 3;
+	accessor1 = 5;
+	REQUIRE(! conflationSet.empty());
+
+	std::vector<std::pair<void *, int> > drained;
+	const std::size_t count = conflationSet.drain([&drained](void * tag, const int value) {
+		drained.push_back({ tag, value });
+	});
+	REQUIRE(count == 2);
+	REQUIRE(conflationSet.empty());
+	REQUIRE(drained.size() == 2);
+	REQUIRE(drained[0].first == &accessor1);
+	REQUIRE(drained[0].second == 5);
+	REQUIRE(drained[1].first == &accessor2);
+	REQUIRE(drained[1].second == 2);
+
+	drained.clear();
+	REQUIRE(conflationSet.drain([&drained](void * tag, const int value) {
+		drained.push_back({ tag, value });
+	}) == 0);
+
+	accessor2 = 8;
+	REQUIRE(conflationSet.drain([&drained](void * tag, const int value) {
+		drained.push_back({ tag, value });
+	}) == 1);
+	REQUIRE(drained[0].first == &accessor2);
+	REQUIRE(drained[0].second == 8);
+}
+
+TEST_CASE("Conflation, not attached")
+{
+	accessorpp::Accessor<int, ConflatedPolicies> accessor;
+	accessor = 5;
+	REQUIRE(accessor == 5);
+}
+
+TEST_CASE("Conflation, multiple threads")
+{
+	constexpr int accessorCount = 8;
+	constexpr int setCount = 10000;
+
+	struct Policies
+	{
+		using Storage = accessorpp::ExternalStorage;
+		using OnChangedCallback = accessorpp::ConflatedCallback<int>;
+	};
+	using AccessorType = accessorpp::Accessor<int, Policies>;
+
+	accessorpp::ConflationSet<int> conflationSet;
+	std::vector<int> values(accessorCount);
+	std::vector<std::unique_ptr<AccessorType> > accessorList;
+	for(int i = 0; i < accessorCount; ++i) {
+		accessorList.emplace_back(new AccessorType(&values[i], &values[i]));
+		accessorList.back()->onChanged().attach(conflationSet, (void *)(std::size_t)i);
+	}
+
+	std::vector<std::thread> threadList;
+	for(int i = 0; i < accessorCount; ++i) {
+		threadList.emplace_back([i, &accessorList]() {
+			for(int k = 1; k <= setCount; ++k) {
+				*accessorList[i] = k;
+			}
+		});
+	}
+
+	std::vector<int> latest(accessorCount);
+	auto consume = [&latest](void * tag, const int value) {
+		const std::size_t index = (std::size_t)tag;
+		// Values of each accessor are observed in non-decreasing order.
+		REQUIRE(value >= latest[index]);
+		latest[index] = value;
+	};
+	int finishedCount = 0;
+	while(finishedCount < accessorCount) {
+		conflationSet.drain(consume);
+		finishedCount = 0;
+		for(int i = 0; i < accessorCount; ++i) {
+			if(latest[i] == setCount) {
+				++finishedCount;
+			}
+		}
+	}
+
+	for(auto & thread : threadList) {
+		thread.join();
+	}
+	conflationSet.drain(consume);
+	REQUIRE(conflationSet.empty());
+}
+
+
+} // namespace
+
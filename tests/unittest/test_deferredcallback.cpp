@@ -0,0 +1,170 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/deferredcallback.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct DeferredPolicies
+{
+	using OnChangedCallback = accessorpp::DeferredCallback<std::function<void (int)> >;
+};
+
+struct IgnoreDeepPolicies
+{
+	using OnChangedCallback = accessorpp::DeferredCallback<std::function<void (int)>, accessorpp::IgnoreError>;
+};
+
+// Restore the default maximum cascade depth.
+struct MaxCascadeDepthScope
+{
+	explicit MaxCascadeDepthScope(const std::size_t depth)
+		: previousDepth(accessorpp::DeferredDispatch::getMaxCascadeDepth())
+	{
+		accessorpp::DeferredDispatch::setMaxCascadeDepth(depth);
+	}
+
+	~MaxCascadeDepthScope() {
+		accessorpp::DeferredDispatch::setMaxCascadeDepth(previousDepth);
+	}
+
+	std::size_t previousDepth;
+};
+
+} // namespace
+
+TEST_CASE("DeferredCallback, without cascade, invoke in set")
+{
+	int changedValue = 0;
+	accessorpp::Accessor<int, DeferredPolicies> accessor;
+	accessor.onChanged() = [&changedValue](const int value) {
+		REQUIRE(accessorpp::DeferredDispatch::isDispatching());
+		REQUIRE(accessorpp::DeferredDispatch::getDepth() == 0);
+		changedValue = value;
+	};
+	accessor = 5;
+	REQUIRE(changedValue == 5);
+	REQUIRE(! accessorpp::DeferredDispatch::isDispatching());
+}
+
+TEST_CASE("DeferredCallback, nested notifications run after the listener returns")
+{
+	std::vector<std::string> eventList;
+	accessorpp::Accessor<int, DeferredPolicies> a;
+	accessorpp::Accessor<int, DeferredPolicies> b;
+	a.onChanged() = [&eventList, &b](const int value) {
+		b = value * 2;
+		// b is already set, its notification is queued.
+		REQUIRE(b == value * 2);
+		REQUIRE(accessorpp::DeferredDispatch::getPendingCount() == 1);
+		eventList.push_back("a " + std::to_string(value));
+	};
+	b.onChanged() = [&eventList](const int value) {
+		REQUIRE(accessorpp::DeferredDispatch::getDepth() == 1);
+		eventList.push_back("b " + std::to_string(value));
+	};
+
+	a = 3;
+	REQUIRE(eventList == std::vector<std::string> { "a 3", "b 6" });
+	REQUIRE(accessorpp::DeferredDispatch::getPendingCount() == 0);
+}
+
+TEST_CASE("DeferredCallback, cycle runs with bounded stack")
+{
+	// 100000 recursive sets would overflow the stack without the deferred dispatching.
+	constexpr int limit = 100000;
+	MaxCascadeDepthScope depthScope(limit + 1);
+
+	accessorpp::Accessor<int, DeferredPolicies> a;
+	accessorpp::Accessor<int, DeferredPolicies> b;
+	a.onChanged() = [&b](const int value) {
+		if(value < limit) {
+			b = value + 1;
+		}
+	};
+	b.onChanged() = [&a](const int value) {
+		if(value < limit) {
+			a = value + 1;
+		}
+	};
+
+	a = 0;
+	REQUIRE(a == limit - (limit % 2 == 0 ? 0 : 1));
+	REQUIRE(b == limit - (limit % 2 == 0 ? 1 : 0));
+}
+
+TEST_CASE("DeferredCallback, cascade too deep, throw")
+{
+	MaxCascadeDepthScope depthScope(10);
+
+	int notifyCount = 0;
+	accessorpp::Accessor<int, DeferredPolicies> accessor;
+	accessor.onChanged() = [&notifyCount, &accessor](const int value) {
+		++notifyCount;
+		accessor = value + 1;
+	};
+
+	REQUIRE_THROWS_AS(accessor = 0, std::logic_error);
+	// The notifications of depth 0 to 10.
+	REQUIRE(notifyCount == 11);
+	REQUIRE(accessor == 11);
+	REQUIRE(! accessorpp::DeferredDispatch::isDispatching());
+	REQUIRE(accessorpp::DeferredDispatch::getPendingCount() == 0);
+}
+
+TEST_CASE("DeferredCallback, cascade too deep, ignored")
+{
+	MaxCascadeDepthScope depthScope(10);
+
+	int notifyCount = 0;
+	accessorpp::Accessor<int, IgnoreDeepPolicies> accessor;
+	accessor.onChanged() = [&notifyCount, &accessor](const int value) {
+		++notifyCount;
+		accessor = value + 1;
+	};
+
+	accessor = 0;
+	REQUIRE(notifyCount == 11);
+	REQUIRE(accessor == 11);
+
+	// The dispatching is finished, the next set starts a new cascade.
+	accessor = 100;
+	REQUIRE(notifyCount == 22);
+	REQUIRE(accessor == 111);
+}
+
+TEST_CASE("DeferredCallback, destroyed accessor drops its queued notification")
+{
+	int notifyCount = 0;
+	std::unique_ptr<accessorpp::Accessor<int, DeferredPolicies> > b(new accessorpp::Accessor<int, DeferredPolicies>());
+	b->onChanged() = [&notifyCount](int) {
+		++notifyCount;
+	};
+
+	accessorpp::Accessor<int, DeferredPolicies> a;
+	a.onChanged() = [&b](const int value) {
+		*b = value;
+		b.reset();
+	};
+
+	a = 1;
+	REQUIRE(notifyCount == 0);
+	REQUIRE(accessorpp::DeferredDispatch::getPendingCount() == 0);
+}
@@ -0,0 +1,77 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "noexceptions.h"
+#include "accessorpp/accessor.h"
+
+#include <functional>
+
+TEST_CASE("ErrorHandler, default handler throws")
+{
+	int value = 1;
+	auto accessor = accessorpp::createReadOnlyAccessor<int>([&value]() { return value; });
+	REQUIRE_THROWS_AS(accessor = 2, std::logic_error);
+	REQUIRE(accessor.trySet(2) == accessorpp::ErrorCode::readOnly);
+	REQUIRE(value == 1);
+
+	accessorpp::Accessor<int, accessorpp::DefaultPolicies> noGetter;
+	noGetter.setGetter(accessorpp::Getter<int>());
+	REQUIRE_THROWS_AS(noGetter.get(), std::bad_function_call);
+}
+
+TEST_CASE("ErrorHandler, empty callable getter is the empty getter")
+{
+	struct IgnoreErrorPolicies
+	{
+		using ErrorHandler = accessorpp::IgnoreError;
+	};
+
+	// The empty getter goes through the error handler, which returns a default constructed value,
+	// instead of calling the empty function.
+	accessorpp::Getter<int, IgnoreErrorPolicies> getter1(std::function<int ()>{});
+	REQUIRE(getter1.get() == 0);
+
+	int (*nullFunc)() = nullptr;
+	accessorpp::Getter<int, IgnoreErrorPolicies> getter2(nullFunc);
+	REQUIRE(getter2.get() == 0);
+
+	accessorpp::Accessor<int, IgnoreErrorPolicies> accessor(std::function<int ()>{}, accessorpp::noSetter);
+	REQUIRE(accessor.get() == 0);
+
+	// The default handler reports the error.
+	accessorpp::Getter<int> getter3(std::function<int ()>{});
+	REQUIRE_THROWS_AS(getter3.get(), std::bad_function_call);
+}
+
+TEST_CASE("ErrorHandler, without exceptions")
+{
+	const NoExceptionsResult result = runNoExceptions();
+	REQUIRE(result.readOnlyValue == 1);
+	REQUIRE(result.emptyGetterValue == 0);
+	REQUIRE(result.emptyCallableGetterValue == 0);
+	REQUIRE(result.emptySetterValue == 5);
+	REQUIRE(result.trySetResult == accessorpp::ErrorCode::readOnly);
+	REQUIRE(result.trySetWritableResult == accessorpp::ErrorCode::ok);
+	REQUIRE(result.writableValue == 8);
+	REQUIRE(result.transactionValue == 3);
+	REQUIRE(result.batchValue == 4);
+	REQUIRE(result.parallelSum == 12);
+	REQUIRE(result.executorValue == 6);
+	REQUIRE(result.errorList == std::vector<accessorpp::ErrorCode> {
+		accessorpp::ErrorCode::readOnly,
+		accessorpp::ErrorCode::readOnly,
+		accessorpp::ErrorCode::emptyGetter,
+		accessorpp::ErrorCode::emptyGetter
+	});
+}
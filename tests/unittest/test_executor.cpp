@@ -0,0 +1,178 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/executor.h"
+#include "accessorpp/threadpool.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+// Run the posted tasks manually
+struct ManualExecutor
+{
+	void post(std::function<void ()> task) {
+		taskList.push_back(std::move(task));
+	}
+
+	void runAll() {
+		while(! taskList.empty()) {
+			auto task = std::move(taskList.front());
+			taskList.erase(taskList.begin());
+			task();
+		}
+	}
+
+	std::vector<std::function<void ()> > taskList;
+};
+
+TEST_CASE("ExecutorCallback, without executor, invoke in set")
+{
+	struct Policies
+	{
+		using OnChangedCallback = accessorpp::ExecutorCallback<std::function<void (int)> >;
+	};
+
+	int changedValue = 0;
+	accessorpp::Accessor<int, Policies> accessor;
+	accessor.onChanged() = [&changedValue](const int value) {
+		changedValue = value;
+	};
+	accessor = 5;
+	REQUIRE(changedValue == 5);
+}
+
+TEST_CASE("ExecutorCallback, user executor, value is captured by copy")
+{
+	struct Policies
+	{
+		using OnChangedCallback = accessorpp::ExecutorCallback<std::function<void (const std::string &, int)> >;
+		using CallbackData = int;
+	};
+
+	std::vector<std::pair<std::string, int> > changedList;
+	ManualExecutor executor;
+	accessorpp::Accessor<std::string, Policies> accessor;
+	accessor.onChanged() = [&changedList](const std::string & value, const int data) {
+		changedList.push_back({ value, data });
+	};
+	accessor.onChanged().setExecutor(executor);
+
+	accessor = "abc";
+	accessor.setWithCallbackData("def", 3);
+	REQUIRE(changedList.empty());
+	// Only one task is posted for the pending invocations.
+	REQUIRE(executor.taskList.size() == 1);
+
+	executor.runAll();
+	REQUIRE(changedList.size() == 2);
+	REQUIRE(changedList[0].first == "abc");
+	REQUIRE(changedList[0].second == 0);
+	REQUIRE(changedList[1].first == "def");
+	REQUIRE(changedList[1].second == 3);
+
+	accessor = "xyz";
+	REQUIRE(executor.taskList.size() == 1);
+	executor.runAll();
+	REQUIRE(changedList.size() == 3);
+	REQUIRE(changedList[2].first == "xyz");
+}
+
+TEST_CASE("ExecutorCallback, a throwing invocation doesn't stop the others")
+{
+	struct Policies
+	{
+		using OnChangedCallback = accessorpp::ExecutorCallback<std::function<void (int)> >;
+	};
+
+	std::vector<int> changedList;
+	ManualExecutor executor;
+	accessorpp::Accessor<int, Policies> accessor;
+	accessor.onChanged() = [&changedList](const int value) {
+		if(value == 2) {
+			throw std::runtime_error("callback");
+		}
+		changedList.push_back(value);
+	};
+	accessor.onChanged().setExecutor(executor);
+
+	accessor = 1;
+	accessor = 2;
+	accessor = 3;
+	REQUIRE_NOTHROW(executor.runAll());
+	REQUIRE(changedList == std::vector<int> { 1, 3 });
+	REQUIRE_THROWS_AS(accessor.onChanged().waitForIdle(), std::runtime_error);
+	REQUIRE_NOTHROW(accessor.onChanged().waitForIdle());
+
+	// The callback is not running, new invocations are scheduled again.
+	accessor = 4;
+	REQUIRE(executor.taskList.size() == 1);
+	executor.runAll();
+	REQUIRE(changedList == std::vector<int> { 1, 3, 4 });
+}
+
+TEST_CASE("ExecutorCallback, ThreadPool, order is preserved per accessor")
+{
+	constexpr int accessorCount = 4;
+	constexpr int setCount = 2000;
+
+	struct Policies
+	{
+		using OnChangedCallback = accessorpp::ExecutorCallback<std::function<void (int)> >;
+	};
+	using AccessorType = accessorpp::Accessor<int, Policies>;
+
+	accessorpp::ThreadPool threadPool(4);
+	REQUIRE(threadPool.getThreadCount() == 4);
+
+	std::vector<std::vector<int> > changedList(accessorCount);
+	std::vector<std::thread::id> threadIdList(accessorCount);
+	{
+		std::vector<std::unique_ptr<AccessorType> > accessorList;
+		for(int i = 0; i < accessorCount; ++i) {
+			accessorList.emplace_back(new AccessorType());
+			accessorList.back()->onChanged() = [i, &changedList, &threadIdList](const int value) {
+				changedList[i].push_back(value);
+				threadIdList[i] = std::this_thread::get_id();
+			};
+			accessorList.back()->onChanged().setExecutor(threadPool);
+		}
+
+		for(int k = 0; k < setCount; ++k) {
+			for(int i = 0; i < accessorCount; ++i) {
+				*accessorList[i] = k;
+			}
+		}
+		// The destructor of the accessors waits for the pending callbacks.
+	}
+
+	for(int i = 0; i < accessorCount; ++i) {
+		REQUIRE(changedList[i].size() == setCount);
+		bool inOrder = true;
+		for(int k = 0; k < setCount; ++k) {
+			inOrder = inOrder && changedList[i][k] == k;
+		}
+		REQUIRE(inOrder);
+		REQUIRE(threadIdList[i] != std::this_thread::get_id());
+	}
+}
+
+
+} // namespace
+
@@ -0,0 +1,60 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/instances.h"
+#include "accessorpp/accessoroperators.h"
+
+namespace {
+
+struct InstancePolicies
+{
+	using Storage = accessorpp::ExternalStorage;
+};
+
+} // namespace
+
+// The instantiations of InstancePolicies are in this file.
+ACCESSORPP_EXTERN_ACCESSOR(int, InstancePolicies)
+ACCESSORPP_INSTANTIATE_ACCESSOR(int, InstancePolicies)
+
+TEST_CASE("instances, common")
+{
+	accessorpp::Accessor<int> intAccessor(3);
+	intAccessor += 2;
+	REQUIRE(intAccessor == 5);
+
+	accessorpp::Accessor<double> doubleAccessor(1.5);
+	doubleAccessor = doubleAccessor * 2;
+	REQUIRE(doubleAccessor.get() == 3.0);
+
+	accessorpp::Accessor<bool> boolAccessor;
+	REQUIRE(! boolAccessor);
+	boolAccessor = true;
+	REQUIRE(boolAccessor.get());
+
+	accessorpp::Accessor<std::string> stringAccessor("abc");
+	stringAccessor += "def";
+	REQUIRE(stringAccessor == "abcdef");
+	REQUIRE(stringAccessor.trySet("x") == accessorpp::ErrorCode::ok);
+	REQUIRE(stringAccessor.get() == "x");
+}
+
+TEST_CASE("instances, user policies")
+{
+	int value = 1;
+	accessorpp::Accessor<int, InstancePolicies> accessor(&value, &value);
+	accessor = 8;
+	REQUIRE(value == 8);
+	REQUIRE(accessor.get() == 8);
+}
@@ -0,0 +1,212 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/instrumentation.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct CountingPolicies
+{
+	using Instrumentation = accessorpp::CountAccesses;
+	using OnChangingCallback = std::function<void (int)>;
+	using OnChangedCallback = std::function<void (int)>;
+	using ErrorHandler = accessorpp::IgnoreError;
+};
+
+struct PerThreadPolicies
+{
+	using Instrumentation = accessorpp::CountAccessesPerThread;
+};
+
+struct NoInstrumentationPolicies
+{
+	using Instrumentation = accessorpp::NoInstrumentation;
+};
+
+struct LiteralPolicies
+{
+	using Storage = accessorpp::LiteralStorage;
+};
+
+static_assert(! accessorpp::Accessor<int>::instrumented, "");
+static_assert(! accessorpp::Accessor<int, NoInstrumentationPolicies>::instrumented, "");
+static_assert(accessorpp::Accessor<int, CountingPolicies>::instrumented, "");
+static_assert(sizeof(accessorpp::Accessor<int, NoInstrumentationPolicies>) == sizeof(accessorpp::Accessor<int>), "");
+static_assert(sizeof(accessorpp::Accessor<int, LiteralPolicies>) == sizeof(int), "");
+
+const accessorpp::AccessCounts * findCounts(const std::vector<accessorpp::AccessCounts> & countsList, const std::string & name)
+{
+	auto it = std::find_if(countsList.begin(), countsList.end(), [&name](const accessorpp::AccessCounts & counts) {
+		return counts.name == name;
+	});
+	return it == countsList.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+TEST_CASE("Instrumentation, CountAccesses")
+{
+	accessorpp::Accessor<int, CountingPolicies> accessor(1);
+	accessor.onChanging() = [](int) {};
+	accessor.onChanged() = [](int) {};
+	accessor.getInstrumentation().setName("counted");
+	REQUIRE(accessor.getInstrumentation().getName() == "counted");
+
+	REQUIRE(accessor.get() == 1);
+	REQUIRE(accessor == 1);
+	int value = accessor;
+	REQUIRE(value == 1);
+	accessor = 2;
+	accessor += 3;
+	REQUIRE(accessor.trySet(6) == accessorpp::ErrorCode::ok);
+
+	accessorpp::AccessCounts counts = accessor.getInstrumentation().getAccessCounts();
+	REQUIRE(counts.name == "counted");
+	REQUIRE(counts.getCount == 3);
+	REQUIRE(counts.setCount == 3);
+	REQUIRE(counts.suppressedSetCount == 0);
+	REQUIRE(counts.callbackCount == 6);
+	REQUIRE(counts.getTotalCount() == 12);
+
+	accessor.getInstrumentation().clear();
+	REQUIRE(accessor.getInstrumentation().getAccessCounts().getTotalCount() == 0);
+}
+
+TEST_CASE("Instrumentation, suppressed sets")
+{
+	struct Policies
+	{
+		using Instrumentation = accessorpp::CountAccesses;
+		using ErrorHandler = accessorpp::IgnoreError;
+	};
+
+	int value = 5;
+	accessorpp::Accessor<int, Policies> accessor(&value, accessorpp::noSetter);
+	accessor = 6;
+	accessor.set(7);
+	REQUIRE(accessor.trySet(8) == accessorpp::ErrorCode::readOnly);
+	REQUIRE(value == 5);
+
+	accessorpp::AccessCounts counts = accessor.getInstrumentation().getAccessCounts();
+	REQUIRE(counts.setCount == 0);
+	REQUIRE(counts.suppressedSetCount == 3);
+}
+
+TEST_CASE("Instrumentation, registry top list")
+{
+	accessorpp::Accessor<int, CountingPolicies> cold;
+	accessorpp::Accessor<int, CountingPolicies> hot;
+	accessorpp::Accessor<int, CountingPolicies> warm;
+	cold.getInstrumentation().setName("test.cold");
+	hot.getInstrumentation().setName("test.hot");
+	warm.getInstrumentation().setName("test.warm");
+	for(int i = 0; i < 100; ++i) {
+		hot.get();
+	}
+	for(int i = 0; i < 50; ++i) {
+		warm.get();
+	}
+	cold.get();
+
+	{
+		const std::vector<accessorpp::AccessCounts> countsList = accessorpp::AccessCounterRegistry::getInstance().getAccessCountsList();
+		REQUIRE(findCounts(countsList, "test.hot")->getCount == 100);
+		REQUIRE(findCounts(countsList, "test.warm")->getCount == 50);
+		REQUIRE(findCounts(countsList, "test.cold")->getCount == 1);
+	}
+
+	const std::vector<accessorpp::AccessCounts> topList = accessorpp::AccessCounterRegistry::getInstance().getTopList(2);
+	REQUIRE(topList.size() == 2);
+	REQUIRE(topList[0].name == "test.hot");
+	REQUIRE(topList[1].name == "test.warm");
+
+	std::stringstream stream;
+	accessorpp::AccessCounterRegistry::getInstance().dumpTopList(stream, 1);
+	REQUIRE(stream.str() == "test.hot: total=100 get=100 set=0 suppressedSet=0 callback=0\n");
+
+}
+
+TEST_CASE("Instrumentation, copied accessor keeps the name and is registered")
+{
+	struct Policies
+	{
+		using Instrumentation = accessorpp::CountAccesses;
+	};
+
+	accessorpp::Accessor<int, Policies> source(3);
+	source.getInstrumentation().setName("test.source");
+	source.get();
+
+	{
+		accessorpp::Accessor<int, Policies> copied(source);
+		REQUIRE(copied.getInstrumentation().getName() == "test.source");
+		REQUIRE(copied.getInstrumentation().getAccessCounts().getTotalCount() == 0);
+		copied.get();
+		copied.get();
+
+		std::vector<accessorpp::AccessCounts> countsList = accessorpp::AccessCounterRegistry::getInstance().getAccessCountsList();
+		const auto count = std::count_if(countsList.begin(), countsList.end(), [](const accessorpp::AccessCounts & counts) {
+			return counts.name == "test.source";
+		});
+		REQUIRE(count == 2);
+		REQUIRE(source.getInstrumentation().getAccessCounts().getCount == 1);
+		REQUIRE(copied.getInstrumentation().getAccessCounts().getCount == 2);
+
+		// Assignment keeps the own instrumentation of the target.
+		accessorpp::Accessor<int, Policies> assigned;
+		assigned.getInstrumentation().setName("test.assigned");
+		assigned = source;
+		REQUIRE(assigned == 3);
+		REQUIRE(assigned.getInstrumentation().getName() == "test.assigned");
+	}
+	REQUIRE(findCounts(accessorpp::AccessCounterRegistry::getInstance().getAccessCountsList(), "test.source") != nullptr);
+}
+
+TEST_CASE("Instrumentation, unregistered when destroyed")
+{
+	{
+		accessorpp::Accessor<int, CountingPolicies> accessor;
+		accessor.getInstrumentation().setName("test.destroyed");
+		REQUIRE(findCounts(accessorpp::AccessCounterRegistry::getInstance().getAccessCountsList(), "test.destroyed") != nullptr);
+	}
+	REQUIRE(findCounts(accessorpp::AccessCounterRegistry::getInstance().getAccessCountsList(), "test.destroyed") == nullptr);
+}
+
+TEST_CASE("Instrumentation, CountAccessesPerThread")
+{
+	constexpr int threadCount = 4;
+	constexpr int iterateCount = 1000;
+
+	accessorpp::Accessor<int, PerThreadPolicies> accessor;
+	std::vector<std::thread> threadList;
+	for(int i = 0; i < threadCount; ++i) {
+		threadList.emplace_back([&accessor]() {
+			for(int k = 0; k < iterateCount; ++k) {
+				accessor.get();
+			}
+		});
+	}
+	for(std::thread & thread : threadList) {
+		thread.join();
+	}
+
+	REQUIRE(accessor.getInstrumentation().getAccessCounts().getCount == threadCount * iterateCount);
+}
@@ -0,0 +1,224 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/parallelcallbacklist.h"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+struct Policies
+{
+	using OnChangedCallback = accessorpp::ParallelCallbackList<void (int)>;
+};
+
+TEST_CASE("ParallelCallbackList, small list is dispatched sequentially")
+{
+	accessorpp::ThreadPool threadPool(2);
+	accessorpp::Accessor<int, Policies> accessor;
+	accessor.onChanged().setThreadPool(&threadPool);
+
+	std::vector<int> valueList;
+	std::vector<std::thread::id> threadIdList;
+	for(int i = 0; i < 3; ++i) {
+		accessor.onChanged().append([&valueList, &threadIdList](const int value) {
+			valueList.push_back(value);
+			threadIdList.push_back(std::this_thread::get_id());
+		});
+	}
+	REQUIRE(accessor.onChanged().size() == 3);
+
+	accessor = 5;
+	REQUIRE(valueList == std::vector<int> { 5, 5, 5 });
+	for(auto id : threadIdList) {
+		REQUIRE(id == std::this_thread::get_id());
+	}
+}
+
+TEST_CASE("ParallelCallbackList, large list is dispatched on the pool and waited")
+{
+	constexpr int listenerCount = 1000;
+
+	accessorpp::ThreadPool threadPool(4);
+	accessorpp::Accessor<int, Policies> accessor;
+	accessor.onChanged().setThreadPool(&threadPool);
+	accessor.onChanged().setParallelThreshold(100);
+
+	std::vector<int> valueList(listenerCount);
+	for(int i = 0; i < listenerCount; ++i) {
+		accessor.onChanged().append([i, &valueList](const int value) {
+			valueList[i] += value;
+		});
+	}
+
+	accessor = 3;
+	accessor = 4;
+	for(int i = 0; i < listenerCount; ++i) {
+		REQUIRE(valueList[i] == 7);
+	}
+}
+
+TEST_CASE("ParallelCallbackList, exception is rethrown after all chunks are finished")
+{
+	constexpr int listenerCount = 1000;
+
+	accessorpp::ThreadPool threadPool(4);
+	accessorpp::Accessor<int, Policies> accessor;
+	accessor.onChanged().setThreadPool(&threadPool);
+	accessor.onChanged().setParallelThreshold(100);
+	accessor.onChanged().setChunkSize(10);
+
+	std::atomic<int> count(0);
+	for(int i = 0; i < listenerCount; ++i) {
+		accessor.onChanged().append([i, &count](const int) {
+			if(i % 100 == 55) {
+				throw std::runtime_error("listener");
+			}
+			++count;
+		});
+	}
+
+	REQUIRE_THROWS_AS(accessor = 3, std::runtime_error);
+	// In each chunk which throws, the listeners after the throwing one are skipped.
+	REQUIRE(count == listenerCount - 10 * 5);
+}
+
+TEST_CASE("ParallelCallbackList, waiting thread doesn't run unrelated tasks")
+{
+	accessorpp::ThreadPool threadPool(1);
+	std::atomic<bool> released(false);
+	std::atomic<bool> unrelatedRun(false);
+	threadPool.post([&released]() {
+		while(! released.load()) {
+			std::this_thread::yield();
+		}
+	});
+	threadPool.post([&unrelatedRun]() {
+		unrelatedRun = true;
+	});
+
+	accessorpp::Accessor<int, Policies> accessor;
+	accessor.onChanged().setThreadPool(&threadPool);
+	accessor.onChanged().setParallelThreshold(10);
+	accessor.onChanged().setChunkSize(10);
+	int sum = 0;
+	for(int i = 0; i < 100; ++i) {
+		accessor.onChanged().append([&sum](const int value) {
+			sum += value;
+		});
+	}
+
+	// The only worker is busy, the calling thread runs all chunks.
+	accessor = 2;
+	REQUIRE(sum == 200);
+	REQUIRE(! unrelatedRun);
+	released = true;
+}
+
+TEST_CASE("ParallelCallbackList, async")
+{
+	constexpr int listenerCount = 500;
+
+	accessorpp::ThreadPool threadPool(4);
+	std::atomic<int> sum(0);
+	{
+		accessorpp::Accessor<int, Policies> accessor;
+		accessor.onChanged().setThreadPool(&threadPool);
+		accessor.onChanged().setParallelThreshold(10);
+		accessor.onChanged().setChunkSize(7);
+		accessor.onChanged().setDispatch(accessorpp::ParallelDispatch::async);
+
+		for(int i = 0; i < listenerCount; ++i) {
+			accessor.onChanged().append([&sum](const int value) {
+				sum += value;
+			});
+		}
+
+		accessor = 2;
+		accessor = 3;
+		accessor.onChanged().waitForIdle();
+		REQUIRE(sum == listenerCount * 5);
+
+		// Appending doesn't affect the pending dispatching.
+		accessor = 1;
+		accessor.onChanged().append([&sum](const int value) {
+			sum += value * 1000;
+		});
+		// The destructor waits for the pending dispatching.
+	}
+	REQUIRE(sum == listenerCount * 6);
+}
+
+TEST_CASE("ParallelCallbackList, async exception is rethrown by waitForIdle")
+{
+	constexpr int listenerCount = 100;
+
+	accessorpp::ThreadPool threadPool(4);
+	accessorpp::Accessor<int, Policies> accessor;
+	accessor.onChanged().setThreadPool(&threadPool);
+	accessor.onChanged().setParallelThreshold(10);
+	accessor.onChanged().setChunkSize(10);
+	accessor.onChanged().setDispatch(accessorpp::ParallelDispatch::async);
+
+	std::atomic<int> count(0);
+	for(int i = 0; i < listenerCount; ++i) {
+		accessor.onChanged().append([i, &count](const int value) {
+			if(value == 1 && i % 10 == 5) {
+				throw std::runtime_error("listener");
+			}
+			++count;
+		});
+	}
+
+	accessor = 1;
+	REQUIRE_THROWS_AS(accessor.onChanged().waitForIdle(), std::runtime_error);
+	// In each chunk, the listeners after the throwing one are skipped.
+	REQUIRE(count == listenerCount / 2);
+
+	// The exception is reported once, the later dispatching is not affected.
+	accessor = 2;
+	REQUIRE_NOTHROW(accessor.onChanged().waitForIdle());
+	REQUIRE(count == listenerCount / 2 + listenerCount);
+
+	// The destructor discards the exception.
+	accessor = 1;
+}
+
+TEST_CASE("ThreadPool, nested tasks")
+{
+	constexpr int taskCount = 100;
+
+	std::atomic<int> count(0);
+	{
+		accessorpp::ThreadPool threadPool(3);
+		for(int i = 0; i < taskCount; ++i) {
+			threadPool.post([&threadPool, &count]() {
+				threadPool.post([&count]() {
+					++count;
+				});
+				++count;
+			});
+		}
+	}
+	REQUIRE(count == taskCount * 2);
+}
+
+
+} // namespace
+
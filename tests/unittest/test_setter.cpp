@@ -196,3 +196,21 @@ TEST_CASE("Setter, istream")
 	stream >> setter;
 	REQUIRE(value == 38);
 }
+
+TEST_CASE("Setter, empty function is no-op")
+{
+	accessorpp::Setter<int> setter1(std::function<void (int)>{});
+	setter1 = 8;
+
+	void (*nullFunc)(int) = nullptr;
+	accessorpp::Setter<int> setter2(nullFunc);
+	setter2 = 8;
+
+	int value = 0;
+	accessorpp::Setter<int> setter3(&value);
+	accessorpp::Setter<int> setter4(std::move(setter3));
+	setter3 = 5;
+	REQUIRE(value == 0);
+	setter4 = 8;
+	REQUIRE(value == 8);
+}
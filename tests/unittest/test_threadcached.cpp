@@ -0,0 +1,189 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/threadcached.h"
+
+#include <string>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ThreadCachedPolicies
+{
+	using Storage = accessorpp::ThreadCachedStorage;
+};
+
+TEST_CASE("ThreadCachedStorage, getter is called only when the cache is invalidated")
+{
+	std::string config = "abc";
+	int getterCount = 0;
+	accessorpp::Accessor<std::string, ThreadCachedPolicies> accessor(
+		[&config, &getterCount]() -> std::string {
+			++getterCount;
+			return config;
+		},
+		[&config](const std::string & value) {
+			config = value;
+		}
+	);
+
+	REQUIRE(accessor.get() == "abc");
+	REQUIRE(accessor.get() == "abc");
+	REQUIRE(accessor.getCached() == "abc");
+	REQUIRE(getterCount == 1);
+
+	// Changing the data directly is not seen until invalidated.
+	config = "def";
+	REQUIRE(accessor.get() == "abc");
+	accessorpp::invalidateThreadCaches();
+	REQUIRE(accessor.get() == "def");
+	REQUIRE(getterCount == 2);
+
+	// Setting via the accessor invalidates the caches.
+	accessor = "xyz";
+	REQUIRE(config == "xyz");
+	REQUIRE(accessor.get() == "xyz");
+	REQUIRE(getterCount == 3);
+}
+
+TEST_CASE("ThreadCachedStorage, staleness")
+{
+	int value = 1;
+	accessorpp::Accessor<int, ThreadCachedPolicies> accessor(
+		[&value]() { return value; },
+		accessorpp::noSetter
+	);
+	REQUIRE(accessor.isReadOnly());
+	accessor.setStaleness(std::chrono::milliseconds(10));
+
+	REQUIRE(accessor.get() == 1);
+	value = 2;
+	REQUIRE(accessor.get() == 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	REQUIRE(accessor.get() == 2);
+}
+
+TEST_CASE("ThreadCachedStorage, copy and destroy")
+{
+	int value = 5;
+	accessorpp::Accessor<int, ThreadCachedPolicies> accessor(
+		[&value]() { return value; },
+		[&value](const int newValue) { value = newValue; }
+	);
+	REQUIRE(accessor.get() == 5);
+	{
+		accessorpp::Accessor<int, ThreadCachedPolicies> copied(accessor);
+		REQUIRE(copied.get() == 5);
+	}
+	int otherValue = 8;
+	// Likely reuses the slot of the destroyed accessor, must not see its cached value.
+	accessorpp::Accessor<int, ThreadCachedPolicies> other(
+		[&otherValue]() { return otherValue; },
+		accessorpp::noSetter
+	);
+	REQUIRE(other.get() == 8);
+	REQUIRE(accessor.get() == 5);
+}
+
+TEST_CASE("ThreadCachedStorage, copy read-only accessor")
+{
+	struct IgnoreErrorPolicies
+	{
+		using Storage = accessorpp::ThreadCachedStorage;
+		using ErrorHandler = accessorpp::IgnoreError;
+	};
+
+	int value = 5;
+	accessorpp::Accessor<int, IgnoreErrorPolicies> accessor(
+		[&value]() { return value; },
+		accessorpp::noSetter
+	);
+	accessorpp::Accessor<int, IgnoreErrorPolicies> copied(accessor);
+	REQUIRE(copied.isReadOnly());
+	REQUIRE(copied.trySet(8) == accessorpp::ErrorCode::readOnly);
+	REQUIRE(copied.get() == 5);
+}
+
+// A value type used only by the test below, so its thread slot list starts empty.
+struct ChainedText
+{
+	std::string text;
+};
+
+TEST_CASE("ThreadCachedStorage, getter reads another cached accessor")
+{
+	std::string source = "abc";
+	// derived gets the lower slot index, so reading base from its getter
+	// grows the thread slot list while derived is refreshing.
+	accessorpp::Accessor<ChainedText, ThreadCachedPolicies> * basePointer = nullptr;
+	accessorpp::Accessor<ChainedText, ThreadCachedPolicies> derived(
+		[&basePointer]() -> ChainedText {
+			return ChainedText{ basePointer->get().text + "!" };
+		},
+		accessorpp::noSetter
+	);
+	accessorpp::Accessor<ChainedText, ThreadCachedPolicies> base(
+		[&source]() -> ChainedText {
+			return ChainedText{ source };
+		},
+		accessorpp::noSetter
+	);
+	basePointer = &base;
+
+	REQUIRE(derived.get().text == "abc!");
+	REQUIRE(base.get().text == "abc");
+	source = "def";
+	accessorpp::invalidateThreadCaches();
+	REQUIRE(derived.get().text == "def!");
+	REQUIRE(base.get().text == "def");
+}
+
+TEST_CASE("ThreadCachedStorage, each thread has its own cache")
+{
+	constexpr int threadCount = 4;
+	constexpr int readCount = 10000;
+
+	std::atomic<int> getterCount(0);
+	accessorpp::Accessor<int, ThreadCachedPolicies> accessor(
+		[&getterCount]() {
+			++getterCount;
+			return 3;
+		},
+		accessorpp::noSetter
+	);
+
+	std::vector<std::thread> threadList;
+	std::atomic<int> sum(0);
+	for(int i = 0; i < threadCount; ++i) {
+		threadList.emplace_back([&accessor, &sum]() {
+			int localSum = 0;
+			for(int k = 0; k < readCount; ++k) {
+				localSum += accessor.get();
+			}
+			sum += localSum;
+		});
+	}
+	for(auto & thread : threadList) {
+		thread.join();
+	}
+
+	REQUIRE(sum == threadCount * readCount * 3);
+	REQUIRE(getterCount == threadCount);
+}
+
+
+} // namespace
+
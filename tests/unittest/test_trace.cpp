@@ -0,0 +1,224 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/accessor.h"
+#include "accessorpp/trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct TracePolicies
+{
+	using Instrumentation = accessorpp::TraceAccesses;
+	using OnChangedCallback = std::function<void (int)>;
+};
+
+struct TraceNoCallbackPolicies
+{
+	using Instrumentation = accessorpp::TraceAccesses;
+};
+
+// Enable the tracing in the scope, and leave the tracer empty and disabled.
+struct TraceScope
+{
+	TraceScope() {
+		accessorpp::Tracer::getInstance().clear();
+		accessorpp::Tracer::setEnabled(true);
+	}
+
+	~TraceScope() {
+		accessorpp::Tracer::setEnabled(false);
+		accessorpp::Tracer::getInstance().setCallbackBudget(std::chrono::nanoseconds(0));
+		accessorpp::Tracer::getInstance().clear();
+	}
+};
+
+std::string getTrace()
+{
+	std::stringstream stream;
+	accessorpp::Tracer::getInstance().writeChromeTrace(stream);
+	return stream.str();
+}
+
+std::size_t countOf(const std::string & text, const std::string & part)
+{
+	std::size_t count = 0;
+	for(std::size_t pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1)) {
+		++count;
+	}
+	return count;
+}
+
+} // namespace
+
+TEST_CASE("Trace, disabled records nothing")
+{
+	accessorpp::Tracer::getInstance().clear();
+	accessorpp::Accessor<int, TracePolicies> accessor;
+	accessor.onChanged() = [](int) {};
+	accessor = 5;
+	REQUIRE(accessor.get() == 5);
+	REQUIRE(accessorpp::Tracer::getInstance().getEventCount() == 0);
+}
+
+TEST_CASE("Trace, set cascades through callbacks")
+{
+	TraceScope traceScope;
+
+	accessorpp::Accessor<int, TracePolicies> width;
+	accessorpp::Accessor<int, TraceNoCallbackPolicies> area;
+	width.getInstrumentation().setName("Window.width");
+	area.getInstrumentation().setName("Window.\"area\"");
+	REQUIRE(width.getInstrumentation().getName() == "Window.width");
+	width.onChanged() = [&area](const int value) {
+		area = value * 10;
+	};
+
+	width = 3;
+	REQUIRE(area == 30);
+
+	// set width, callback width, set area, end area, end callback, end width.
+	REQUIRE(accessorpp::Tracer::getInstance().getEventCount() == 6);
+
+	const std::string trace = getTrace();
+	REQUIRE(trace.find("{\"traceEvents\":[") == 0);
+	REQUIRE(countOf(trace, "\"ph\":\"B\"") == 3);
+	REQUIRE(countOf(trace, "\"ph\":\"E\"") == 3);
+	REQUIRE(countOf(trace, "\"cat\":\"callback\"") == 2);
+	REQUIRE(countOf(trace, "\"name\":\"Window.\\\"area\\\"\"") == 2);
+
+	const std::size_t widthSet = trace.find("{\"name\":\"Window.width\",\"ph\":\"B\"");
+	const std::size_t widthCallback = trace.find("\"cat\":\"callback\"");
+	const std::size_t areaSet = trace.find("{\"name\":\"Window.\\\"area\\\"\",\"ph\":\"B\"");
+	REQUIRE(widthSet < widthCallback);
+	REQUIRE(widthCallback < areaSet);
+	REQUIRE(trace.find("overBudget") == std::string::npos);
+}
+
+TEST_CASE("Trace, callbacks over budget")
+{
+	TraceScope traceScope;
+	accessorpp::Tracer::getInstance().setCallbackBudget(std::chrono::milliseconds(1));
+
+	accessorpp::Accessor<int, TracePolicies> accessor;
+	accessor.getInstrumentation().setName("slow");
+	accessor.onChanged() = [](const int value) {
+		if(value == 2) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	};
+	accessor = 1;
+	accessor = 2;
+
+	REQUIRE(accessorpp::Tracer::getInstance().getOverBudgetCount() == 1);
+	const std::string trace = getTrace();
+	REQUIRE(countOf(trace, "\"overBudget\":true") == 1);
+	REQUIRE(countOf(trace, "\"name\":\"over budget: slow\"") == 1);
+}
+
+TEST_CASE("Trace, threads and full buffers")
+{
+	TraceScope traceScope;
+	accessorpp::Tracer::getInstance().setBufferCapacity(8);
+
+	std::vector<std::thread> threadList;
+	for(int i = 0; i < 2; ++i) {
+		threadList.emplace_back([]() {
+			accessorpp::Accessor<int, TraceNoCallbackPolicies> accessor;
+			for(int k = 0; k < 10; ++k) {
+				accessor = k;
+			}
+		});
+	}
+	for(std::thread & thread : threadList) {
+		thread.join();
+	}
+	accessorpp::Tracer::getInstance().setBufferCapacity(1024 * 64);
+
+	// Each set records 2 events, a buffer holds 8 events.
+	REQUIRE(accessorpp::Tracer::getInstance().getEventCount() == 16);
+	REQUIRE(accessorpp::Tracer::getInstance().getDroppedCount() == 24);
+	const std::string trace = getTrace();
+	REQUIRE(countOf(trace, "\"name\":\"(unnamed)\"") == 16);
+	REQUIRE(countOf(trace, "\"tid\":") == 16);
+}
+
+TEST_CASE("Trace, buffers of the exited threads are freed by clear")
+{
+	TraceScope traceScope;
+	const std::size_t bufferCount = accessorpp::Tracer::getInstance().getBufferCount();
+
+	std::thread([]() {
+		accessorpp::Accessor<int, TraceNoCallbackPolicies> accessor;
+		accessor = 1;
+	}).join();
+	// The events of the exited thread are kept.
+	REQUIRE(accessorpp::Tracer::getInstance().getEventCount() == 2);
+	REQUIRE(accessorpp::Tracer::getInstance().getBufferCount() == bufferCount + 1);
+
+	accessorpp::Tracer::getInstance().clear();
+	REQUIRE(accessorpp::Tracer::getInstance().getEventCount() == 0);
+	REQUIRE(accessorpp::Tracer::getInstance().getBufferCount() == bufferCount);
+
+	// A thread exiting without events frees its buffer immediately.
+	std::thread([]() {
+		accessorpp::Accessor<int, TraceNoCallbackPolicies> accessor;
+		accessor = 1;
+		accessorpp::Tracer::getInstance().clear();
+	}).join();
+	REQUIRE(accessorpp::Tracer::getInstance().getBufferCount() == bufferCount);
+}
+
+TEST_CASE("Trace, clear while other threads are recording")
+{
+	TraceScope traceScope;
+
+	std::atomic<bool> stopped(false);
+	std::thread thread([&stopped]() {
+		accessorpp::Accessor<int, TraceNoCallbackPolicies> accessor;
+		int value = 0;
+		while(! stopped.load()) {
+			accessor = ++value;
+		}
+	});
+	for(int i = 0; i < 100; ++i) {
+		accessorpp::Tracer::getInstance().clear();
+		const std::string trace = getTrace();
+		REQUIRE(countOf(trace, "\"ph\":\"B\"") >= countOf(trace, "\"ph\":\"E\""));
+	}
+	stopped = true;
+	thread.join();
+}
+
+TEST_CASE("Trace, toggling discards the unfinished begins")
+{
+	TraceScope traceScope;
+	accessorpp::Accessor<int, TracePolicies> accessor;
+	accessor.onChanged() = [](int) {
+		accessorpp::Tracer::setEnabled(false);
+		accessorpp::Tracer::setEnabled(true);
+	};
+
+	accessor = 1;
+	// The set and the callback began before the toggling, their ends are not recorded.
+	const std::string trace = getTrace();
+	REQUIRE(countOf(trace, "\"ph\":\"B\"") == 2);
+	REQUIRE(countOf(trace, "\"ph\":\"E\"") == 0);
+}
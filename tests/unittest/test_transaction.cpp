@@ -0,0 +1,208 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/transaction.h"
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+struct TransactionalPolicies
+{
+	using Storage = accessorpp::TransactionalStorage;
+};
+
+struct TransactionalCallbackPolicies
+{
+	using Storage = accessorpp::TransactionalStorage;
+	using OnChangingCallback = std::function<void (int)>;
+	using OnChangedCallback = std::function<void (int)>;
+};
+
+TEST_CASE("TransactionalStorage, get and set without transaction")
+{
+	accessorpp::Accessor<std::string, TransactionalPolicies> accessor("abc");
+	REQUIRE(accessor.get() == "abc");
+	accessor = "def";
+	REQUIRE(accessor.get() == "def");
+	REQUIRE(accessor.directGet() == "def");
+
+	accessorpp::Accessor<std::string, TransactionalPolicies> copied(accessor);
+	REQUIRE(copied.get() == "def");
+	copied = "xyz";
+	REQUIRE(copied.get() == "xyz");
+	REQUIRE(accessor.get() == "def");
+}
+
+TEST_CASE("Transaction, commit publishes all writes, callbacks are invoked after commit")
+{
+	accessorpp::Accessor<int, TransactionalCallbackPolicies> bid(1);
+	accessorpp::Accessor<int, TransactionalCallbackPolicies> ask(2);
+
+	int changingCount = 0;
+	std::vector<std::pair<int, int> > changedList;
+	bid.onChanging() = [&changingCount](int) {
+		++changingCount;
+	};
+	bid.onChanged() = [&changedList, &bid, &ask](const int value) {
+		changedList.push_back({ value, bid.get() + ask.get() });
+	};
+	ask.onChanged() = [&changedList, &bid, &ask](const int value) {
+		changedList.push_back({ value, bid.get() + ask.get() });
+	};
+
+	accessorpp::Transaction transaction;
+	transaction.set(bid, 10);
+	transaction.set(ask, 20);
+	transaction.set(bid, 11);
+	REQUIRE(transaction.get(bid) == 11);
+	// Not published before commit.
+	REQUIRE(bid.get() == 1);
+	REQUIRE(ask.get() == 2);
+	REQUIRE(changedList.empty());
+
+	REQUIRE(transaction.commit());
+	REQUIRE(bid.get() == 11);
+	REQUIRE(ask.get() == 20);
+	REQUIRE(changingCount == 0);
+	REQUIRE(changedList.size() == 2);
+	for(const auto & item : changedList) {
+		REQUIRE(item.second == 31);
+	}
+}
+
+TEST_CASE("Transaction, conflict")
+{
+	accessorpp::Accessor<int, TransactionalPolicies> accessor1(1);
+	accessorpp::Accessor<int, TransactionalPolicies> accessor2(2);
+
+	accessorpp::Transaction transaction;
+	REQUIRE(transaction.get(accessor1) == 1);
+	// Changed by others after the transaction read it.
+	accessor1 = 5;
+	transaction.set(accessor2, 3);
+	REQUIRE(! transaction.commit());
+	REQUIRE(accessor2.get() == 2);
+
+	int runCount = 0;
+	accessorpp::transact([&](accessorpp::Transaction & tx) {
+		++runCount;
+		const int value = tx.get(accessor1);
+		if(runCount == 1) {
+			accessor1 = 6;
+		}
+		tx.set(accessor2, value + 1);
+	});
+	REQUIRE(runCount == 2);
+	REQUIRE(accessor2.get() == 7);
+}
+
+TEST_CASE("Transaction, conflicting read aborts the transaction body")
+{
+	accessorpp::Accessor<int, TransactionalPolicies> accessor1(1);
+	accessorpp::Accessor<int, TransactionalPolicies> accessor2(2);
+
+	int runCount = 0;
+	int finishedCount = 0;
+	accessorpp::transact([&](accessorpp::Transaction & tx) {
+		++runCount;
+		const int value1 = tx.get(accessor1);
+		if(runCount == 1) {
+			// Changed by others after the transaction began, reading it aborts the body.
+			accessor2 = 10;
+		}
+		const int value2 = tx.get(accessor2);
+		++finishedCount;
+		tx.set(accessor1, value1 + value2);
+	});
+	REQUIRE(runCount == 2);
+	REQUIRE(finishedCount == 1);
+	REQUIRE(accessor1.get() == 11);
+
+	// Used directly, the transaction isn't aborted, the conflict is reported by isValid and commit.
+	accessorpp::Transaction transaction;
+	accessor2 = 20;
+	REQUIRE(transaction.get(accessor2) == 20);
+	REQUIRE(! transaction.isValid());
+	REQUIRE(! transaction.commit());
+}
+
+TEST_CASE("Transaction, set converts the value to the value type of the accessor")
+{
+	accessorpp::Accessor<double, TransactionalPolicies> accessor(1.5);
+	accessorpp::Accessor<std::string, TransactionalPolicies> text;
+	accessorpp::transact([&](accessorpp::Transaction & tx) {
+		tx.set(accessor, 5);
+		tx.set(text, "abc");
+	});
+	REQUIRE(accessor.get() == 5.0);
+	REQUIRE(text.get() == "abc");
+}
+
+TEST_CASE("Transaction, readers never observe a mix of old and new values")
+{
+	constexpr int writerCount = 2;
+	constexpr int writeCount = 5000;
+
+	accessorpp::Accessor<int, TransactionalPolicies> bid(0);
+	accessorpp::Accessor<int, TransactionalPolicies> ask(0);
+	accessorpp::Accessor<int, TransactionalPolicies> counter(0);
+	std::atomic<bool> stopped(false);
+	std::atomic<int> mixCount(0);
+
+	std::thread reader([&]() {
+		while(! stopped.load()) {
+			int b = 0;
+			int a = 0;
+			accessorpp::transact([&](accessorpp::Transaction & tx) {
+				b = tx.get(bid);
+				a = tx.get(ask);
+			});
+			if(a != b + 1 && ! (a == 0 && b == 0)) {
+				++mixCount;
+			}
+		}
+	});
+
+	std::vector<std::thread> writerList;
+	for(int i = 0; i < writerCount; ++i) {
+		writerList.emplace_back([&]() {
+			for(int k = 0; k < writeCount; ++k) {
+				accessorpp::transact([&](accessorpp::Transaction & tx) {
+					const int value = tx.get(counter) + 1;
+					tx.set(counter, value);
+					tx.set(bid, value);
+					tx.set(ask, value + 1);
+				});
+			}
+		});
+	}
+	for(auto & thread : writerList) {
+		thread.join();
+	}
+	stopped.store(true);
+	reader.join();
+
+	REQUIRE(mixCount == 0);
+	REQUIRE(counter.get() == writerCount * writeCount);
+	REQUIRE(bid.get() == writerCount * writeCount);
+	REQUIRE(ask.get() == writerCount * writeCount + 1);
+}
+
+
+} // namespace
+
@@ -0,0 +1,195 @@
+// accessorpp library
+// Copyright (C) 2022 Wang Qi (wqking)
+// Github: https://github.com/wqking/accessorpp
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//   http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test.h"
+#include "accessorpp/versionedobject.h"
+
+#include <string>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct VersionedPolicies
+{
+	using Storage = accessorpp::VersionedStorage;
+};
+
+struct Rect
+{
+	Rect()
+		:
+			object(),
+			width(object, 1),
+			height(object, 2),
+			name(object, "rect")
+	{
+	}
+
+	accessorpp::VersionedObject object;
+	accessorpp::Accessor<int, VersionedPolicies> width;
+	accessorpp::Accessor<int, VersionedPolicies> height;
+	accessorpp::Accessor<std::string, VersionedPolicies> name;
+};
+
+TEST_CASE("VersionedStorage, get and set")
+{
+	Rect rect;
+	REQUIRE(rect.width.get() == 1);
+	REQUIRE(rect.height.get() == 2);
+	REQUIRE(rect.name.get() == "rect");
+
+	rect.width = 5;
+	rect.name = "abc";
+	REQUIRE(rect.width.get() == 5);
+	REQUIRE(rect.width.directGet() == 5);
+	REQUIRE(rect.name.get() == "abc");
+
+	accessorpp::Accessor<int, VersionedPolicies> copied(rect.width);
+	REQUIRE(copied.get() == 5);
+	copied = 8;
+	REQUIRE(copied.get() == 8);
+	REQUIRE(rect.width.get() == 5);
+}
+
+TEST_CASE("VersionedObject, snapshot isn't affected by later writes")
+{
+	Rect rect;
+	accessorpp::VersionedSnapshot snapshot = rect.object.snapshot();
+	REQUIRE(snapshot.isValid());
+	const std::uint64_t version = snapshot.getVersion();
+
+	rect.width = 10;
+	rect.name = "def";
+	REQUIRE(rect.object.getVersion() == version + 2);
+
+	REQUIRE(snapshot.getVersion() == version);
+	REQUIRE(snapshot.get(rect.width) == 1);
+	REQUIRE(snapshot.get(rect.height) == 2);
+	REQUIRE(snapshot.get(rect.name) == "rect");
+
+	accessorpp::VersionedSnapshot newSnapshot = rect.object.snapshot();
+	REQUIRE(newSnapshot.get(rect.width) == 10);
+	REQUIRE(newSnapshot.get(rect.name) == "def");
+
+	Rect other;
+	REQUIRE_THROWS(snapshot.get(other.width));
+}
+
+TEST_CASE("VersionedObject, batch")
+{
+	Rect rect;
+	const std::uint64_t version = rect.object.getVersion();
+	rect.object.batch([&rect]() {
+		rect.width = 3;
+		rect.height = 4;
+		// The batch thread sees its own writes.
+		REQUIRE(rect.width.get() == 3);
+		REQUIRE(rect.object.snapshot().get(rect.width) == 1);
+	});
+	REQUIRE(rect.object.getVersion() == version + 1);
+	REQUIRE(rect.object.snapshot().get(rect.width) == 3);
+	REQUIRE(rect.object.snapshot().get(rect.height) == 4);
+}
+
+TEST_CASE("VersionedObject, slots of destroyed accessors are reused")
+{
+	accessorpp::VersionedObject object;
+	accessorpp::Accessor<int, VersionedPolicies> kept(object, 1);
+	for(int i = 0; i < 1000; ++i) {
+		accessorpp::Accessor<int, VersionedPolicies> accessor(object, i);
+		REQUIRE(accessor.get() == i);
+	}
+	REQUIRE(object.getSlotCount() == 2);
+	REQUIRE(kept.get() == 1);
+
+	std::unique_ptr<accessorpp::Accessor<int, VersionedPolicies> > destroyed(
+		new accessorpp::Accessor<int, VersionedPolicies>(object, 5)
+	);
+	const std::size_t slot = destroyed->getVersionedSlot().index;
+	const accessorpp::VersionedSnapshot snapshot = object.snapshot();
+	destroyed.reset();
+	accessorpp::Accessor<std::string, VersionedPolicies> reused(object, "abc");
+	REQUIRE(reused.getVersionedSlot().index == slot);
+	REQUIRE(reused.get() == "abc");
+	// The accessor is created after the snapshot, though its slot is in the snapshot.
+	REQUIRE_THROWS(snapshot.get(reused));
+	REQUIRE(object.snapshot().get(reused) == "abc");
+}
+
+TEST_CASE("VersionedObject, many accessors")
+{
+	constexpr int accessorCount = 100;
+
+	accessorpp::VersionedObject object;
+	std::vector<std::unique_ptr<accessorpp::Accessor<int, VersionedPolicies> > > accessorList;
+	for(int i = 0; i < accessorCount; ++i) {
+		accessorList.emplace_back(new accessorpp::Accessor<int, VersionedPolicies>(object, i));
+	}
+	const accessorpp::VersionedSnapshot snapshot = object.snapshot();
+	object.batch([&accessorList]() {
+		*accessorList[1] = 1000;
+		*accessorList[50] = 5000;
+		*accessorList[51] = 5100;
+	});
+	*accessorList[99] = 9900;
+
+	const accessorpp::VersionedSnapshot newSnapshot = object.snapshot();
+	for(int i = 0; i < accessorCount; ++i) {
+		REQUIRE(snapshot.get(*accessorList[i]) == i);
+	}
+	REQUIRE(newSnapshot.get(*accessorList[0]) == 0);
+	REQUIRE(newSnapshot.get(*accessorList[1]) == 1000);
+	REQUIRE(newSnapshot.get(*accessorList[50]) == 5000);
+	REQUIRE(newSnapshot.get(*accessorList[51]) == 5100);
+	REQUIRE(newSnapshot.get(*accessorList[98]) == 98);
+	REQUIRE(newSnapshot.get(*accessorList[99]) == 9900);
+}
+
+TEST_CASE("VersionedObject, readers always see consistent snapshot")
+{
+	constexpr int writeCount = 20000;
+
+	Rect rect;
+	rect.width = 0;
+	rect.height = 0;
+	std::atomic<bool> stopped(false);
+	std::atomic<int> mixCount(0);
+
+	std::thread reader([&]() {
+		while(! stopped.load()) {
+			const accessorpp::VersionedSnapshot snapshot = rect.object.snapshot();
+			if(snapshot.get(rect.width) != snapshot.get(rect.height)) {
+				++mixCount;
+			}
+		}
+	});
+
+	for(int i = 1; i <= writeCount; ++i) {
+		rect.object.batch([&rect, i]() {
+			rect.width = i;
+			rect.height = i;
+		});
+	}
+	stopped.store(true);
+	reader.join();
+
+	REQUIRE(mixCount == 0);
+	REQUIRE(rect.object.snapshot().get(rect.height) == writeCount);
+}
+
+
+} // namespace
+
@@ -0,0 +1,100 @@
+# accessorpp library
+# Copyright (C) 2022 Wang Qi (wqking)
+# Github: https://github.com/wqking/accessorpp
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#   http://www.apache.org/licenses/LICENSE-2.0
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Report the bytes of code emitted for each accessorpp template instantiation.
+# Usage: python3 codesize.py [--json] [--nm NM] file...
+# The files are object files, libraries or executables which nm can read.
+# Each code symbol is attributed to the first accessorpp class template in its
+# demangled name, e.g, std::function handlers of the getter functors of
+# Accessor<int> are attributed to private_::AddressGetterFunc<int, int>.
+# The symbols with the same name in multiple files are counted once.
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+
+codeSymbolTypes = 'tTwWiI'
+templateNamePattern = re.compile(r'accessorpp::(?:private_::)?(\w+)<')
+# The traits used in the return types of the operators, such as std::enable_if<IsAccessor<T>::value, T &>.
+ignoredTemplateNameList = [ 'IsAccessor', 'IsAccessorExpression', 'IsGetter', 'AccessorValueType' ]
+
+def readSymbols(nm, fileName) :
+	output = subprocess.run(
+		[ nm, '--demangle', '--print-size', '--defined-only', fileName ],
+		check = True,
+		stdout = subprocess.PIPE,
+		universal_newlines = True
+	).stdout
+	for line in output.splitlines() :
+		parts = line.split(' ', 3)
+		if len(parts) < 4 or parts[2] not in codeSymbolTypes :
+			continue
+		yield parts[3], int(parts[1], 16)
+
+def findInstantiation(symbol) :
+	match = templateNamePattern.search(symbol)
+	while match is not None and match.group(1) in ignoredTemplateNameList :
+		match = templateNamePattern.search(symbol, match.end())
+	if match is None :
+		return None
+	depth = 0
+	for index in range(match.end() - 1, len(symbol)) :
+		if symbol[index] == '<' :
+			depth += 1
+		elif symbol[index] == '>' :
+			depth -= 1
+			if depth == 0 :
+				return symbol[match.start() : index + 1]
+	return None
+
+def collect(nm, fileNameList) :
+	sizeMap = {}
+	for fileName in fileNameList :
+		for symbol, size in readSymbols(nm, fileName) :
+			instantiation = findInstantiation(symbol)
+			if instantiation is None :
+				continue
+			sizeMap.setdefault(instantiation, {})[symbol] = size
+	result = []
+	for instantiation, symbolMap in sizeMap.items() :
+		result.append({
+			'instantiation' : instantiation,
+			'bytes' : sum(symbolMap.values()),
+			'symbols' : len(symbolMap)
+		})
+	result.sort(key = lambda item : (-item['bytes'], item['instantiation']))
+	return result
+
+def main() :
+	parser = argparse.ArgumentParser(description = 'Report code size of accessorpp instantiations.')
+	parser.add_argument('--json', action = 'store_true', help = 'output JSON')
+	parser.add_argument('--nm', default = 'nm', help = 'the nm program')
+	parser.add_argument('files', nargs = '+')
+	args = parser.parse_args()
+
+	result = collect(args.nm, args.files)
+	if args.json :
+		print(json.dumps({
+			'totalBytes' : sum(item['bytes'] for item in result),
+			'instantiations' : result
+		}, indent = '\t'))
+		return
+
+	for item in result :
+		print('%8d %4d  %s' % (item['bytes'], item['symbols'], item['instantiation']))
+	print('%8d       total' % sum(item['bytes'] for item in result))
+
+if __name__ == '__main__' :
+	sys.exit(main())
@@ -1,29 +1,64 @@
 logicOperatorList = [
-	'==', '!=', '>', '>=', '<', '<=',
-	'&&', '||',
+	[ '==', 'Equal' ],
+	[ '!=', 'NotEqual' ],
+	[ '>', 'Greater' ],
+	[ '>=', 'GreaterEqual' ],
+	[ '<', 'Less' ],
+	[ '<=', 'LessEqual' ],
+	[ '&&', 'LogicalAnd' ],
+	[ '||', 'LogicalOr' ],
 ]
+
+comparisonOperatorTemplate = '''
+struct ComparisonOperator{name}
+{
+	template <typename L, typename R>
+	static constexpr bool apply(const L & a, const R & b)
+	{
+		return a {op} b;
+	}
+};
+'''
+
 logicOperatorTemplate = '''
 template <typename T, typename U>
-auto operator {op} (const T & a, const U & b)
-	-> typename std::enable_if<IsAccessor<T>::value, bool>::type
+constexpr auto operator {op} (const T & a, const U & b)
+	-> typename std::enable_if<IsAccessor<T>::value || private_::IsAccessorExpression<T>::value, bool>::type
 {
-	return (typename AccessorValueType<T>::Type)(a) {op} (typename AccessorValueType<U>::Type)(b);
+	return private_::compareOperands<private_::ComparisonOperator{name}>(a, b);
 }
 '''
 
 binaryOperatorList = [
-	'+', '-', '*', '/', '%',
-	'&', '|', '^', '<<', '>>',
+	[ '+', 'Add' ],
+	[ '-', 'Subtract' ],
+	[ '*', 'Multiply' ],
+	[ '/', 'Divide' ],
+	[ '%', 'Modulo' ],
+	[ '&', 'BitAnd' ],
+	[ '|', 'BitOr' ],
+	[ '^', 'BitXor' ],
+	[ '<<', 'ShiftLeft' ],
+	[ '>>', 'ShiftRight' ],
 ]
 
+expressionOperatorTemplate = '''
+struct ExpressionOperator{name}
+{
+	template <typename L, typename R>
+	static constexpr auto apply(const L & a, const R & b) -> decltype(a {op} b)
+	{
+		return a {op} b;
+	}
+};
+'''
+
 binaryOperatorTemplate = '''
 template <typename T, typename U>
-auto operator {op} (const T & a, const U & b)
-	-> typename std::enable_if<IsAccessor<T>::value && T::internalStorage, T>::type
+constexpr auto operator {op} (T && a, U && b)
+	-> typename private_::MakeBinaryExpression<private_::ExpressionOperator{name}, T, U>::type
 {
-	T result(a);
-	result = (typename AccessorValueType<T>::Type)(a) {op} (typename AccessorValueType<U>::Type)(b);
-	return result;
+	return typename private_::MakeBinaryExpression<private_::ExpressionOperator{name}, T, U>::type(a, b);
 }
 '''
 
@@ -34,22 +69,36 @@ binaryAssignOperatorList = [
 
 binaryAssignOperatorTemplate = '''
 template <typename T, typename U>
-auto operator {op} (T & a, const U & b)
+ACCESSORPP_CONSTEXPR17 auto operator {op} (T & a, const U & b)
 	-> typename std::enable_if<IsAccessor<T>::value, T &>::type
 {
-	a = (typename AccessorValueType<T>::Type)(a) {rop} (typename AccessorValueType<U>::Type)(b);
+	using V = typename T::UnderlyingType;
+	const typename AccessorValueType<U>::Type & value = (typename AccessorValueType<U>::Type)(b);
+	a.update([&value](const V & oldValue) -> V {
+		return (V)(oldValue {rop} value);
+	});
 	return a;
 }
 '''
 
 def doGenerate(operatorList, operatorTemplate) :
 	for operator in operatorList :
+		name = ''
+		if isinstance(operator, list) :
+			name = operator[1]
+			operator = operator[0]
 		rop = operator.replace('=', '')
 		code = operatorTemplate;
 		code = code.replace('{op}', operator)
 		code = code.replace('{rop}', rop)
+		code = code.replace('{name}', name)
 		print(code, end = '')
 
+print('// Expression operators')
+print('\nnamespace private_ {')
+doGenerate(binaryOperatorList, expressionOperatorTemplate)
+doGenerate(logicOperatorList, comparisonOperatorTemplate)
+print('\n} // namespace private_\n')
 print('// Logic operators')
 doGenerate(logicOperatorList, logicOperatorTemplate)
 print('// Binary operators')